@@ -10,6 +10,24 @@
 
 #include "AdsrData.h"
 
+namespace
+{
+    // tempo liniowe jak w juce::ADSR, -1 = etap pominiety
+    float getRate(float distance, float timeInSeconds, double sampleRate)
+    {
+        return timeInSeconds > 0.0f ? (float)(distance / (timeInSeconds * sampleRate)) : -1.0f;
+    }
+
+    // wspolczynnik krzywej: od 0 do 1 (cala skala) w timeInSeconds przy asymptocie overshoot za koncem
+    float getCoefficient(float timeInSeconds, double sampleRate, float overshoot)
+    {
+        if (timeInSeconds <= 0.0f)
+            return 0.0f;
+
+        return (float)std::exp(-std::log((1.0 + overshoot) / overshoot) / (timeInSeconds * sampleRate));
+    }
+}
+
 void AdsrData::updateADSR(const float attack, const float decay, const float sustain, const float release)
 {
     adsrParams.attack = attack;
@@ -18,4 +36,168 @@ void AdsrData::updateADSR(const float attack, const float decay, const float sus
     adsrParams.release = release;
 
     setParameters(adsrParams);
-}
\ No newline at end of file
+}
+
+void AdsrData::setParameters(const Parameters& newParameters)
+{
+    adsrParams = newParameters;
+    recalculateRates();
+}
+
+void AdsrData::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+    recalculateRates();
+}
+
+void AdsrData::setCurve(int newCurve)
+{
+    curve = juce::jlimit(0, numCurves - 1, newCurve);
+}
+
+void AdsrData::recalculateRates() noexcept
+{
+    // exp/log tylko tutaj, przy zmianie parametrow
+    attackRate = getRate(1.0f, adsrParams.attack, sampleRate);
+    decayRate = getRate(1.0f - adsrParams.sustain, adsrParams.decay, sampleRate);
+    releaseRate = getRate(releaseLevel, adsrParams.release, sampleRate);
+
+    attackCoefficient = getCoefficient(adsrParams.attack, sampleRate, attackOvershoot);
+    decayCoefficient = getCoefficient(adsrParams.decay, sampleRate, decayOvershoot);
+    releaseCoefficient = getCoefficient(adsrParams.release, sampleRate, decayOvershoot);
+
+    if ((state == State::attack && attackRate <= 0.0f)
+        || (state == State::decay && (decayRate <= 0.0f || envelopeVal <= adsrParams.sustain))
+        || (state == State::release && adsrParams.release <= 0.0f))
+        goToNextState();
+}
+
+void AdsrData::noteOn() noexcept
+{
+    if (attackRate > 0.0f)
+        state = State::attack;
+    else if (decayRate > 0.0f)
+    {
+        envelopeVal = 1.0f;
+        state = State::decay;
+    }
+    else
+    {
+        envelopeVal = adsrParams.sustain;
+        state = State::sustain;
+    }
+}
+
+void AdsrData::noteOff() noexcept
+{
+    if (state == State::idle)
+        return;
+
+    if (adsrParams.release > 0.0f)
+    {
+        // release trwa zawsze release sekund od obecnego poziomu
+        releaseLevel = envelopeVal;
+        releaseRate = getRate(releaseLevel, adsrParams.release, sampleRate);
+        state = State::release;
+    }
+    else
+        reset();
+}
+
+void AdsrData::reset() noexcept
+{
+    envelopeVal = 0.0f;
+    state = State::idle;
+}
+
+void AdsrData::goToNextState() noexcept
+{
+    if (state == State::attack)
+        state = decayRate > 0.0f ? State::decay : State::sustain;
+    else if (state == State::decay)
+        state = State::sustain;
+    else if (state == State::release)
+        reset();
+}
+
+void AdsrData::renderBlock(float* output, int numSamples) noexcept
+{
+    while (numSamples > 0)
+    {
+        int done = numSamples;
+
+        switch (state)
+        {
+        case State::idle:
+            juce::FloatVectorOperations::clear(output, numSamples);
+            break;
+        case State::sustain:
+            envelopeVal = adsrParams.sustain;
+            juce::FloatVectorOperations::fill(output, envelopeVal, numSamples);
+            break;
+        case State::attack:
+            done = renderSegment(output, numSamples, 1.0f, attackRate, attackCoefficient, 1.0f + attackOvershoot);
+            break;
+        case State::decay:
+            done = renderSegment(output, numSamples, adsrParams.sustain, -decayRate, decayCoefficient,
+                adsrParams.sustain - decayOvershoot);
+            break;
+        case State::release:
+            done = renderSegment(output, numSamples, 0.0f, -releaseRate, releaseCoefficient, -decayOvershoot);
+            break;
+        }
+
+        output += done;
+        numSamples -= done;
+    }
+}
+
+int AdsrData::renderSegment(float* output, int numSamples, float end, float rate, float coefficient, float asymptote) noexcept
+{
+    const float start = envelopeVal;
+    const float distance = end - start;
+
+    // ile probek do konca etapu - ostatnia z nich dostaje dokladnie end, potem nastepny etap
+    // (juz na koncu albo za nim - jedna probka)
+    double samplesToEnd = 1.0;
+    if (curve == exponentialCurve)
+    {
+        const float remainingRatio = (end - asymptote) / (start - asymptote);
+        if (remainingRatio > 0.0f && remainingRatio < 1.0f)
+            samplesToEnd = juce::jmax(1.0, std::ceil(std::log((double)remainingRatio) / std::log((double)coefficient)));
+    }
+    else if (distance * rate > 0.0f)
+        samplesToEnd = std::ceil(distance / rate);
+
+    const bool segmentEnds = samplesToEnd <= numSamples;
+    const int numRamp = segmentEnds ? juce::jmax(0, (int)samplesToEnd - 1) : numSamples;
+
+    if (curve == exponentialCurve)
+    {
+        // kolejne probki tylko mnozeniem i dodawaniem
+        const float offset = asymptote * (1.0f - coefficient);
+        float value = start;
+        for (int i = 0; i < numRamp; ++i)
+        {
+            value = offset + value * coefficient;
+            output[i] = value;
+        }
+        envelopeVal = value;
+    }
+    else
+    {
+        // wprost z indeksu, bez zaleznosci miedzy probkami
+        for (int i = 0; i < numRamp; ++i)
+            output[i] = start + rate * (float)(i + 1);
+        envelopeVal = start + rate * (float)numRamp;
+    }
+
+    if (!segmentEnds)
+        return numSamples;
+
+    envelopeVal = end;
+    output[numRamp] = end;
+    goToNextState();
+    return numRamp + 1;
+}
@@ -11,12 +11,63 @@
 #pragma once
 #include <JuceHeader.h>
 
-class AdsrData : public juce::ADSR
+// obwiednia ADSR liczona calymi blokami: blok dzielony na granicach etapow, kazdy kawalek wypelniany wprost
+// (liniowo z indeksu albo krzywa wykladnicza mnozeniem), sustain i cisza jednym fill - bez switcha na kazda probke
+// zachowanie jak juce::ADSR (te same parametry, tempa i przejscia miedzy etapami)
+class AdsrData
 {
 public:
+    using Parameters = juce::ADSR::Parameters;
+
+    enum Curve
+    {
+        linearCurve = 0,        // jak juce::ADSR
+        exponentialCurve,       // jak ladowanie kondensatora (analogowe), bez std::exp na probke
+        numCurves
+    };
+
     void updateADSR(const float attack, const float decay, const float sustain, const float release);
+    void setParameters(const Parameters& newParameters);
+    const Parameters& getParameters() const noexcept { return adsrParams; }
+    void setSampleRate(double newSampleRate);
+    void setCurve(int newCurve);
+    int getCurve() const noexcept { return curve; }
 
+    void noteOn() noexcept;
+    void noteOff() noexcept;
+    void reset() noexcept;
+    bool isActive() const noexcept { return state != State::idle; }
+
+    // numSamples kolejnych wartosci obwiedni do output
+    void renderBlock(float* output, int numSamples) noexcept;
+    float getNextSample() noexcept
+    {
+        float sample = 0.0f;
+        renderBlock(&sample, 1);
+        return sample;
+    }
 
 private:
-    juce::ADSR::Parameters adsrParams;
-};
\ No newline at end of file
+    enum class State { idle, attack, decay, sustain, release };
+
+    void recalculateRates() noexcept;
+    void goToNextState() noexcept;
+    // jeden etap od biezacej wartosci do end, zwraca ile probek zapisal (krocej = etap sie skonczyl)
+    int renderSegment(float* output, int numSamples, float end, float rate, float coefficient, float asymptote) noexcept;
+
+    Parameters adsrParams;
+    double sampleRate = 44100.0;
+    int curve = linearCurve;
+
+    State state = State::idle;
+    float envelopeVal = 0.0f;
+
+    // liniowo: zmiana na probke (jak juce::ADSR), release liczony od poziomu przy noteOff
+    float attackRate = 0.0f, decayRate = 0.0f, releaseRate = 0.0f;
+    float releaseLevel = 0.0f;
+
+    // wykladniczo: v = asymptota + (v - asymptota) * wspolczynnik, asymptota za koncem etapu, zeby go osiagnac
+    static constexpr float attackOvershoot = 0.3f;
+    static constexpr float decayOvershoot = 0.0001f;
+    float attackCoefficient = 0.0f, decayCoefficient = 0.0f, releaseCoefficient = 0.0f;
+};
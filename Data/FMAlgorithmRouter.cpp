@@ -10,83 +10,313 @@
 
 #include "FMAlgorithmRouter.h"
 #include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <utility>
 
-float FMAlgorithmRouter::processAlgorithm(int algorithmIndex,
-    OscData& osc1, OscData& osc2, OscData& osc3, OscData& osc4,
-    float env1, float env2, float env3, float env4)
+namespace
 {
-    float out1 = 0.0f, out2 = 0.0f, out3 = 0.0f, out4 = 0.0f;
-    switch (algorithmIndex)
-    {
-        // algorytm 1: osc4 -> osc3 -> osc2 -> osc1
-    case 0:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(out4, env3);
-        out2 = osc2.getModulatedSample(out3, env2);
-        out1 = osc1.getModulatedSample(out2, env1);
-        return out1;
-
-        // algorytm 2: (osc4 + osc3) -> osc2 -> osc1
-    case 1:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(0.0f, env3);
-        out2 = osc2.getModulatedSample(out4 + out3, env2);
-        out1 = osc1.getModulatedSample(out2, env1);
-        return out1;
-
-        // algorytm 3: osc4 -> (osc3 + osc2) -> osc1
-    case 2:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(out4, env3);
-        out2 = osc2.getModulatedSample(out4, env2);
-        out1 = osc1.getModulatedSample(out3 + out2, env1);
-        return out1;
-
-        // algorytm 4: osc4 -> osc3 -> (osc2 + osc1)
-    case 3:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(out4, env3);
-        out2 = osc2.getModulatedSample(out3, env2);
-        out1 = osc1.getModulatedSample(out3, env1);
-        return (out2 + out1) * 0.5f;
-
-        // algorytm 5: (osc4 + osc3 + osc2) -> osc1
-    case 4:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(0.0f, env3);
-        out2 = osc2.getModulatedSample(0.0f, env2);
-        out1 = osc1.getModulatedSample(out4 + out3 + out2, env1);
-        return out1;
-
-        // algorytm 6: osc4 -> (osc3 + osc2 + osc1)
-    case 5:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(out4, env3);
-        out2 = osc2.getModulatedSample(out4, env2);
-        out1 = osc1.getModulatedSample(out4, env1);
-        return (out3 + out2 + out1) / 3.0f;
-
-        // algorytm 7: (osc4 + osc3) -> (osc2 + osc1)
-    case 6:
-    {
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(0.0f, env3);
-        float combinedMod = out4 + out3;
-        out2 = osc2.getModulatedSample(combinedMod, env2);
-        out1 = osc1.getModulatedSample(combinedMod, env1);
-        return (out2 + out1) * 0.5f;
-    }
-
-        // algorytm 8: osc4 + osc3 + osc2 + osc1
-    case 7:
-        out4 = osc4.getModulatedSample(0.0f, env4);
-        out3 = osc3.getModulatedSample(0.0f, env3);
-        out2 = osc2.getModulatedSample(0.0f, env2);
-        out1 = osc1.getModulatedSample(0.0f, env1);
-        return (out4 + out3 + out2 + out1) * 0.25f;
-
-    default:
+    // specjalizowane wersje dla presetow - modulator ma zawsze wyzszy numer niz nosna, wiec liczymy od osc4 do osc1
+    constexpr const RoutingMatrix* routings = RoutingPresets::algorithms;
+
+    constexpr int highestOperator(int mask)
+    {
+        return (mask & 8) ? 3 : (mask & 4) ? 2 : (mask & 2) ? 1 : 0;
+    }
+
+    // dlugosc najdluzszej sciezki modulacji do osc1..osc4 (1 = sam operator)
+    constexpr int operatorDepth(const RoutingMatrix& routing, int op)
+    {
+        int depth = 1;
+        for (int m = 0; m < 4; ++m)
+            if ((routing.modulators[op] >> m) & 1)
+                depth = juce::jmax(depth, 1 + operatorDepth(routing, m));
+        return depth;
+    }
+
+    constexpr int chainDepth(int algorithm)
+    {
+        int depth = 1;
+        for (int op = 0; op < 4; ++op)
+            if ((routings[algorithm].carriers >> op) & 1)
+                depth = juce::jmax(depth, operatorDepth(routings[algorithm], op));
+        return depth;
+    }
+
+    constexpr int countOperators(int mask)
+    {
+        return ((mask >> 0) & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+    }
+
+    // suma od najwyzszego operatora: (out4 + out3) + out2 ...
+    template <int Mask, typename Value>
+    inline Value addOutputs(Value sum, const Value* outputs) noexcept
+    {
+        if constexpr (Mask == 0)
+            return sum;
+        else
+            return addOutputs<Mask & ~(1 << highestOperator(Mask))>(sum + outputs[highestOperator(Mask)], outputs);
+    }
+
+    template <int Mask, typename Value>
+    inline Value sumOutputs(const Value* outputs) noexcept
+    {
+        static_assert(Mask != 0, "pusta suma");
+        return addOutputs<Mask & ~(1 << highestOperator(Mask))>(outputs[highestOperator(Mask)], outputs);
+    }
+
+    // srednia nosnych
+    template <int Carriers, bool Exact, typename Value>
+    inline Value mixCarriers(Value sum) noexcept
+    {
+        constexpr int count = countOperators(Carriers);
+
+        if constexpr (count == 1)
+            return sum;
+        else if constexpr (count == 2)
+            return sum * 0.5f;
+        else if constexpr (count == 3 && Exact)
+            return sum / 3.0f;
+        else if constexpr (count == 3)
+            return sum * (1.0f / 3.0f);
+        else
+            return sum * 0.25f;
+    }
+
+    //==============================================================================
+    // operator po operatorze calymi blokami (rozne ksztalty fal)
+    template <typename Operators, int Algorithm, int Op>
+    void processStagedOperator(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples)
+    {
+        constexpr auto routing = routings[Algorithm];
+        constexpr int modulators = routing.modulators[Op];
+        const int numValues = numSamples * Operators::numLanes;
+
+        // jedyna nosna osc1 pisze od razu na wyjscie
+        float* out = (Op == 0 && routing.carriers == 1) ? output : blocks.out[Op];
+
+        if (operators.isPruned(Op))
+        {
+            // bez wkladu - faza dalej, zera dla nosnych i modulowanych
+            operators.skip(Op, numSamples);
+            std::fill(out, out + numValues, 0.0f);
+            return;
+        }
+
+        if constexpr (modulators == 0)
+        {
+            operators.process(Op, nullptr, blocks.env[Op], out, numSamples);
+        }
+        else if ((modulators & ~operators.prunedOperators) == 0)
+        {
+            // wszystkie modulatory pominiete
+            operators.process(Op, nullptr, blocks.env[Op], out, numSamples);
+        }
+        else if constexpr (countOperators(modulators) == 1)
+        {
+            operators.process(Op, blocks.out[highestOperator(modulators)], blocks.env[Op], out, numSamples);
+        }
+        else
+        {
+            float* mod = blocks.modulation;
+            const float* outputs[4] = { blocks.out[0], blocks.out[1], blocks.out[2], blocks.out[3] };
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                const float values[4] = { outputs[0][i], outputs[1][i], outputs[2][i], outputs[3][i] };
+                mod[i] = sumOutputs<modulators>(values);
+            }
+
+            operators.process(Op, mod, blocks.env[Op], out, numSamples);
+        }
+    }
+
+    template <typename Operators, int Algorithm>
+    void processStaged(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples)
+    {
+        constexpr int carriers = routings[Algorithm].carriers;
+
+        processStagedOperator<Operators, Algorithm, 3>(operators, blocks, output, numSamples);
+        processStagedOperator<Operators, Algorithm, 2>(operators, blocks, output, numSamples);
+        processStagedOperator<Operators, Algorithm, 1>(operators, blocks, output, numSamples);
+        processStagedOperator<Operators, Algorithm, 0>(operators, blocks, output, numSamples);
+
+        if constexpr (carriers != 1)
+        {
+            const int numValues = numSamples * Operators::numLanes;
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                const float values[4] = { blocks.out[0][i], blocks.out[1][i], blocks.out[2][i], blocks.out[3][i] };
+                output[i] = mixCarriers<carriers, true>(sumOutputs<carriers>(values));
+            }
+        }
+    }
+
+    //==============================================================================
+    // caly lancuch czterech operatorow w jednej petli, stan i wyjscia operatorow w rejestrach
+    template <typename Vec, int Algorithm, int WaveType, int Precision, int Mode, int Op>
+    inline void processChainOperator(OperatorRegisters<Vec>* registers, Vec* outputs,
+        const OperatorBlocks& blocks, int offset) noexcept
+    {
+        constexpr int modulators = routings[Algorithm].modulators[Op];
+
+        Vec modulation;
+        if constexpr (modulators == 0)
+            modulation = OperatorKernel::splat<Vec>(0.0f);
+        else
+            modulation = sumOutputs<modulators>(outputs);
+
+        outputs[Op] = OperatorKernel::tick<Vec, WaveType, Precision, Mode>(registers[Op], modulation,
+            OperatorKernel::load<Vec>(blocks.env[Op] + offset));
+    }
+
+    template <typename Operators, int Algorithm, int WaveType, int Precision, int Mode>
+    void processChain(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples)
+    {
+        using Vec = OperatorKernel::VectorType<Operators::numLanes>;
+        constexpr int lanes = Operators::numLanes;
+        constexpr int carriers = routings[Algorithm].carriers;
+
+        OperatorRegisters<Vec> registers[4];
+        for (int op = 0; op < 4; ++op)
+            registers[op] = OperatorKernel::loadRegisters<Vec>(operators.getState(op),
+                operators.getDcBlockerCoefficient(op), operators.getModulationScale(op));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const int offset = i * lanes;
+            Vec outputs[4];
+
+            processChainOperator<Vec, Algorithm, WaveType, Precision, Mode, 3>(registers, outputs, blocks, offset);
+            processChainOperator<Vec, Algorithm, WaveType, Precision, Mode, 2>(registers, outputs, blocks, offset);
+            processChainOperator<Vec, Algorithm, WaveType, Precision, Mode, 1>(registers, outputs, blocks, offset);
+            processChainOperator<Vec, Algorithm, WaveType, Precision, Mode, 0>(registers, outputs, blocks, offset);
+
+            OperatorKernel::store(output + offset,
+                mixCarriers<carriers, Operators::exact>(sumOutputs<carriers>(outputs)));
+        }
+
+        for (int op = 0; op < 4; ++op)
+            OperatorKernel::storeRegisters(registers[op], operators.getState(op));
+    }
+
+    //==============================================================================
+    template <typename Operators>
+    using AlgorithmFunction = void (*)(Operators&, const OperatorBlocks&, float*, int);
+
+    template <typename Operators, int... Index>
+    constexpr std::array<AlgorithmFunction<Operators>, sizeof...(Index)> makeStagedTable(std::integer_sequence<int, Index...>)
+    {
+        return { { &processStaged<Operators, Index>... } };
+    }
+
+    // wspolna petla oplaca sie tylko przy matematyce inline w rejestrach SIMD (std::sin to wywolanie funkcji)
+    // i tylko bez lancucha modulatorow - kolejne operatory w jednej probce licza sie szeregowo;
+    // od fazy calkowitej, PolyBLEP i trybu PM tick pily/prostokata/trojkata nie miesci sie w rejestrach
+    // dla czterech operatorow naraz i wolniejszy jest nawet algorytm 8 (Tests/Benchmarks/AlgorithmBenchmark)
+    template <typename Operators, int Algorithm, int WaveType, int Precision, int Mode>
+    constexpr AlgorithmFunction<Operators> chooseKernel()
+    {
+        using Vec = OperatorKernel::VectorType<Operators::numLanes>;
+
+        if constexpr (!Operators::exact && WaveType == OperatorKernel::sineWave && chainDepth(Algorithm) == 1)
+            return &processChain<Operators, Algorithm, WaveType, OperatorKernel::effectivePrecision<Vec, Precision>, Mode>;
+        else
+            return &processStaged<Operators, Algorithm>;
+    }
+
+    // indeks = ((algorytm * numModulationModes + tryb) * numPrecisions + dokladnosc) * numWaveTypes + ksztalt fali
+    constexpr int numWaveVariants = OperatorKernel::numPrecisions * FMAlgorithmRouter::numWaveTypes;
+    constexpr int numChainVariants = OperatorKernel::numModulationModes * numWaveVariants;
+
+    template <typename Operators, int... Index>
+    constexpr std::array<AlgorithmFunction<Operators>, sizeof...(Index)> makeChainTable(std::integer_sequence<int, Index...>)
+    {
+        return { { chooseKernel<Operators, Index / numChainVariants,
+            Index % FMAlgorithmRouter::numWaveTypes,
+            (Index % numWaveVariants) / FMAlgorithmRouter::numWaveTypes,
+            (Index % numChainVariants) / numWaveVariants>()... } };
+    }
+
+    // nieznany ksztalt liczony jest jak sinus (jak w OperatorKernel)
+    inline int waveIndex(int waveType) noexcept
+    {
+        return juce::isPositiveAndBelow(waveType, FMAlgorithmRouter::numWaveTypes) ? waveType : 0;
+    }
+
+    inline int precisionIndex(int precision) noexcept
+    {
+        return juce::isPositiveAndBelow(precision, (int)OperatorKernel::numPrecisions) ? precision : 0;
+    }
+
+    inline int modeIndex(int mode) noexcept
+    {
+        return juce::isPositiveAndBelow(mode, (int)OperatorKernel::numModulationModes) ? mode : 0;
+    }
+}
+
+template <typename Operators>
+void FMAlgorithmRouter::processBlock(int algorithmIndex, Operators& operators,
+    const OperatorBlocks& blocks, float* output, int numSamples)
+{
+    static constexpr auto stagedTable = makeStagedTable<Operators>(std::make_integer_sequence<int, numAlgorithms>());
+    static constexpr auto chainTable = makeChainTable<Operators>(std::make_integer_sequence<int, numAlgorithms * numChainVariants>());
+
+    if (!juce::isPositiveAndBelow(algorithmIndex, numAlgorithms))
+    {
         jassertfalse; // zly indeks algorytmu na wszelki
-        return 0.0f;
+        std::fill(output, output + numSamples * Operators::numLanes, 0.0f);
+        return;
     }
-}
\ No newline at end of file
+
+    const int wave = waveIndex(operators.getWaveType(0));
+    const int precision = precisionIndex(operators.getPrecision(0));
+    const int mode = modeIndex(operators.getModulationMode(0));
+    bool sameVariant = true;
+
+    for (int op = 1; op < 4; ++op)
+        sameVariant = sameVariant && wave == waveIndex(operators.getWaveType(op))
+                                  && precision == precisionIndex(operators.getPrecision(op))
+                                  && mode == modeIndex(operators.getModulationMode(op));
+
+    // pominiete operatory tylko w wersji operator po operatorze
+    if (sameVariant && operators.prunedOperators == 0)
+        chainTable[(size_t)(((algorithmIndex * OperatorKernel::numModulationModes + mode) * OperatorKernel::numPrecisions + precision) * numWaveTypes + wave)](operators, blocks, output, numSamples);
+    else
+        stagedTable[(size_t)algorithmIndex](operators, blocks, output, numSamples);
+}
+
+template <typename Operators>
+int FMAlgorithmRouter::findPrunedOperators(const RoutingMatrix& routing, const Operators& operators,
+    const OperatorBlocks& blocks, int numSamples)
+{
+    constexpr int lanes = Operators::numLanes;
+    const int numValues = numSamples * lanes;
+    const auto isZero = [](float value) { return value == 0.0f; };
+
+    // cisza: najpierw gain (tanio), potem obwiednia - grajaca zwykle konczy szukanie na pierwszej probce
+    int silent = 0;
+    for (int op = 0; op < Operators::numOperators; ++op)
+    {
+        const float* gain = operators.getState(op).gain;
+        const float* env = blocks.env[op];
+
+        if (std::all_of(gain, gain + lanes, isZero) || std::all_of(env, env + numValues, isZero))
+            silent |= 1 << op;
+    }
+
+    // wklad maja nosne z dzwiekiem i ich modulatory z dzwiekiem (tez przez sprzezenie)
+    int live = routing.carriers & ~silent;
+    for (int pass = 0; pass < Operators::numOperators; ++pass)
+        for (int op = 0; op < Operators::numOperators; ++op)
+            if ((live >> op) & 1)
+                live |= (routing.modulators[op] | routing.feedback[op]) & ~silent;
+
+    return ((1 << Operators::numOperators) - 1) & ~live;
+}
+
+template void FMAlgorithmRouter::processBlock<VoiceOperators>(int, VoiceOperators&, const OperatorBlocks&, float*, int);
+template void FMAlgorithmRouter::processBlock<LaneOperators>(int, LaneOperators&, const OperatorBlocks&, float*, int);
+template int FMAlgorithmRouter::findPrunedOperators<VoiceOperators>(const RoutingMatrix&, const VoiceOperators&, const OperatorBlocks&, int);
+template int FMAlgorithmRouter::findPrunedOperators<LaneOperators>(const RoutingMatrix&, const LaneOperators&, const OperatorBlocks&, int);
@@ -10,12 +10,94 @@
 
 #pragma once
 #include "OscData.h"
+#include "RoutingMatrix.h"
+
+// bufory jednego bloku dla operatorow (dostarcza glos, uzywane pierwsze Operators::numOperators)
+struct OperatorBlocks
+{
+    const float* env[RoutingMatrix::maxOperators];  // obwiednie osc1..osc8
+    float* out[RoutingMatrix::maxOperators];        // wyjscia osc1..osc8
+    float* modulation;                              // suma kilku modulatorow
+};
+
+// operatory jednego glosu
+struct VoiceOperators
+{
+    static constexpr int numLanes = 1;
+    static constexpr int numOperators = 4;
+    static constexpr bool exact = true;     // operator po operatorze i miks przez dzielenie jak dotad
+
+    OscData* osc[4];
+    int prunedOperators = 0;    // bity operatorow pominietych w tym bloku (findPrunedOperators)
+
+    OperatorState<1>& getState(int index) { return osc[index]->getState(); }
+    const OperatorState<1>& getState(int index) const { return osc[index]->getState(); }
+    bool isPruned(int index) const { return (prunedOperators >> index) & 1; }
+    int getWaveType(int index) const { return osc[index]->getKernelWave(); }
+    int getPrecision(int index) const { return osc[index]->getPrecision(); }
+    int getModulationMode(int index) const { return osc[index]->getModulationMode(); }
+    float getModulationScale(int index) const { return osc[index]->getModulationScale(); }
+    float getDcBlockerCoefficient(int index) const { return osc[index]->getDcBlockerCoefficient(); }
+
+    void process(int index, const float* modulation, const float* env, float* output, int numSamples)
+    {
+        osc[index]->processBlock(modulation, env, output, numSamples);
+    }
+
+    void skip(int index, int numSamples) { OperatorKernel::skip(osc[index]->getState(), numSamples); }
+};
+
+// te same operatory kilku glosow naraz, bufory ulozone [probka][glos]
+struct LaneOperators
+{
+    static constexpr int numLanes = OperatorKernel::numLanes;
+    static constexpr int numOperators = 4;
+    static constexpr bool exact = false;
+
+    OperatorState<numLanes> state[4];
+    int waveType[4] = {};       // OperatorKernel::Wave
+    int precision[4] = {};      // exactPrecision liczony tu wielomianem
+    int modulationMode[4] = {}; // OperatorKernel::ModulationMode
+    float modulationScale[4] = {};
+    float dcBlockerCoefficient = 1.0f;
+    int prunedOperators = 0;    // pominiete we wszystkich glosach grupy
+
+    OperatorState<numLanes>& getState(int index) { return state[index]; }
+    const OperatorState<numLanes>& getState(int index) const { return state[index]; }
+    bool isPruned(int index) const { return (prunedOperators >> index) & 1; }
+    int getWaveType(int index) const { return waveType[index]; }
+    int getPrecision(int index) const { return precision[index]; }
+    int getModulationMode(int index) const { return modulationMode[index]; }
+    float getModulationScale(int index) const { return modulationScale[index]; }
+    float getDcBlockerCoefficient(int) const { return dcBlockerCoefficient; }
+
+    void process(int index, const float* modulation, const float* env, float* output, int numSamples)
+    {
+        OperatorKernel::process(state[index], waveType[index], precision[index], modulationMode[index], dcBlockerCoefficient,
+            modulationScale[index], modulation, env, output, numSamples);
+    }
+
+    void skip(int index, int numSamples) { OperatorKernel::skip(state[index], numSamples); }
+};
 
 class FMAlgorithmRouter
 {
 public:
+    static constexpr int numAlgorithms = RoutingPresets::numAlgorithms;
+    static constexpr int numWaveTypes = OperatorKernel::numWaves;
+
+    // Operators = VoiceOperators albo LaneOperators, algorytmy z RoutingPresets bez sprzezen
+    // wersja algorytmu wybierana z tablicy raz na blok:
+    // ten sam ksztalt fali, dokladnosc i tryb modulacji na wszystkich operatorach - caly lancuch w jednej petli po probkach,
+    // rozne - operator po operatorze calymi blokami
+    template <typename Operators>
+    static void processBlock(int algorithmIndex, Operators& operators,
+        const OperatorBlocks& blocks, float* output, int numSamples);
 
-    static float processAlgorithm(int algorithmIndex,
-        OscData& osc1, OscData& osc2, OscData& osc3, OscData& osc4,
-        float env1, float env2, float env3, float env4);
+    // operatory bez wkladu w tym bloku: gain 0 albo obwiednia (z rampa gainu) same zera we wszystkich glosach,
+    // do tego modulatory, ktore moduluja tylko takie operatory - do Operators::prunedOperators przed processBlock,
+    // pominiete licza tylko faze (OperatorKernel::skip), ich wyjscie to zera
+    template <typename Operators>
+    static int findPrunedOperators(const RoutingMatrix& routing, const Operators& operators,
+        const OperatorBlocks& blocks, int numSamples);
 };
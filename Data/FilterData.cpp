@@ -10,16 +10,23 @@
 
 #include "FilterData.h"
 
-void FilterData::prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels)
+void FilterData::prepareToPlay(double newSampleRate, int samplesPerBlock, int numChannels)
 {
-    filter.reset();
+    juce::ignoreUnused(samplesPerBlock);
+    sampleRate = newSampleRate;
 
-    juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.sampleRate = sampleRate;
-    spec.numChannels = numChannels;
+    // tan tylko tutaj - ponizej Nyquista, wyzsze odciecia jak 0.49 fs
+    gTable.resize((size_t)(20000.0f / gTableStep) + 2);
+    for (size_t i = 0; i < gTable.size(); ++i)
+    {
+        const double frequency = juce::jmin((double)i * gTableStep, 0.49 * sampleRate);
+        gTable[i] = (float)std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    }
 
-    filter.prepare(spec);
+    s1.assign((size_t)numChannels, 0.0f);
+    s2.assign((size_t)numChannels, 0.0f);
+    lastType = -1;
+    reset();
 
     isPrepared = true;
 }
@@ -28,31 +35,169 @@ void FilterData::process(juce::AudioBuffer<float>& buffer)
 {
     jassert(isPrepared);
 
-    juce::dsp::AudioBlock<float> block { buffer };
-    filter.process(juce::dsp::ProcessContextReplacing<float> { block });
+    for (int channel = 0; channel < juce::jmin(buffer.getNumChannels(), (int)s1.size()); ++channel)
+    {
+        float* samples = buffer.getWritePointer(channel);
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            samples[i] = processSample(channel, samples[i]);
+    }
 }
 
-void FilterData::updateParameters(int   filterType,
+bool FilterData::updateParameters(int   filterType,
     float baseCutoff,
     float resonance,
     float envValue /* 0-1 */)
 {
-    using FType = juce::dsp::StateVariableTPTFilterType;
-    filter.setType(static_cast<FType> (filterType));
+    // wspolczynniki tylko przy zmianie - w sustainie obwiedni filtra wejscia stoja w miejscu
+    if (filterType == lastType && baseCutoff == lastCutoff && resonance == lastResonance && envValue == lastEnvValue)
+        return false;
 
-    float modCutoff = baseCutoff + envValue * (20000.0f - baseCutoff);
+    lastType = filterType;
+    lastCutoff = baseCutoff;
+    lastResonance = resonance;
+    lastEnvValue = envValue;
 
-    modCutoff = juce::jlimit(20.0f, 20000.0f, modCutoff);
-    filter.setCutoffFrequency(modCutoff);
-    filter.setResonance(resonance);
+    setTypeAndResonance(filterType, resonance);
+    setCutoff(getModulatedCutoff(baseCutoff, envValue));
+    return true;
+}
+
+void FilterData::setTypeAndResonance(int filterType, float resonance)
+{
+    type = juce::jlimit((int)lowpass, (int)highpass, filterType);
+
+    const float newR2 = 1.0f / resonance;
+    if (newR2 != R2)
+    {
+        R2 = newR2;
+        h = 1.0f / (1.0f + R2 * g + g * g);
+    }
+}
+
+void FilterData::setCutoff(float cutoff) noexcept
+{
+    currentCutoff = cutoff;
+    g = getG(cutoff);
+    h = 1.0f / (1.0f + R2 * g + g * g);
+}
+
+float FilterData::getG(float cutoff) const noexcept
+{
+    jassert(!gTable.empty());
+
+    const float position = juce::jlimit(0.0f, 20000.0f, cutoff) * (1.0f / gTableStep);
+    const int index = (int)position;
+    const float fraction = position - (float)index;
+    return gTable[(size_t)index] + fraction * (gTable[(size_t)index + 1] - gTable[(size_t)index]);
+}
+
+int FilterData::processBlock(float* samples, const float* baseCutoff, const float* envValue, int numSamples)
+{
+    return processBlock(juce::dsp::AudioBlock<float>(&samples, 1, (size_t)numSamples), baseCutoff, envValue);
+}
+
+int FilterData::processBlock(juce::dsp::AudioBlock<float> block, const float* baseCutoff, const float* envValue)
+{
+    jassert(isPrepared && block.getNumChannels() <= s1.size());
+
+    // typ wybrany raz na blok, nie w kazdej probce
+    switch (type)
+    {
+    case bandpass: return processChannels<bandpass>(block, baseCutoff, envValue);
+    case highpass: return processChannels<highpass>(block, baseCutoff, envValue);
+    default:       return processChannels<lowpass>(block, baseCutoff, envValue);
+    }
+}
+
+template <int FilterType>
+int FilterData::processChannels(juce::dsp::AudioBlock<float>& block, const float* baseCutoff, const float* envValue) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    const int numChannels = juce::jmin((int)block.getNumChannels(), (int)s1.size());
+    int numUpdates = 0;
+
+    for (int start = 0; start < numSamples; start += controlInterval)
+    {
+        const int count = juce::jmin(controlInterval, numSamples - start);
+
+        // punkt kontrolny na koncu odcinka - wspolczynniki dochodza do niego liniowo, bez schodkow
+        const int last = start + count - 1;
+        const float cutoff = getModulatedCutoff(baseCutoff[last], envValue[last]);
+        const float startG = g;
+        bool ramp = false;
+
+        if (cutoff != currentCutoff)
+        {
+            ++numUpdates;
+            ramp = currentCutoff >= 0.0f;
+            setCutoff(cutoff);
+        }
+
+        // h liczone z g w kazdej probce - h interpolowane osobno nie pasuje do g w srodku rampy
+        // i przy duzym skoku odciecia (np. szybki atak obwiedni) filtr sie rozbiega
+        const float gStep = (g - startG) / (float)count;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            float* segment = block.getChannelPointer((size_t)channel) + start;
+            float z1 = s1[(size_t)channel], z2 = s2[(size_t)channel];
+
+            if (ramp)
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    const float gain = startG + gStep * (float)(i + 1);
+                    segment[i] = tick<FilterType>(segment[i], z1, z2, gain, 1.0f / (1.0f + R2 * gain + gain * gain));
+                }
+            }
+            else
+            {
+                for (int i = 0; i < count; ++i)
+                    segment[i] = tick<FilterType>(segment[i], z1, z2, g, h);
+            }
+
+            s1[(size_t)channel] = z1;
+            s2[(size_t)channel] = z2;
+        }
+    }
+
+    return numUpdates;
+}
+
+template <int FilterType>
+float FilterData::tick(float input, float& z1, float& z2, float gain, float normalisation) const noexcept
+{
+    const float yHP = normalisation * (input - z1 * (gain + R2) - z2);
+    const float yBP = yHP * gain + z1;
+    z1 = yHP * gain + yBP;
+    const float yLP = yBP * gain + z2;
+    z2 = yBP * gain + yLP;
+
+    if constexpr (FilterType == bandpass)
+        return yBP;
+    else if constexpr (FilterType == highpass)
+        return yHP;
+    else
+        return yLP;
 }
 
 void FilterData::reset()
 {
-    filter.reset();
+    std::fill(s1.begin(), s1.end(), 0.0f);
+    std::fill(s2.begin(), s2.end(), 0.0f);
+    // nowa nuta - pierwszy punkt kontrolny bez rampy od poprzedniego odciecia
+    currentCutoff = -1.0f;
 }
 
 float FilterData::processSample(int channel, float inputSample)
 {
-    return filter.processSample(channel, inputSample);
-}
\ No newline at end of file
+    auto& z1 = s1[(size_t)channel];
+    auto& z2 = s2[(size_t)channel];
+
+    switch (type)
+    {
+    case bandpass: return tick<bandpass>(inputSample, z1, z2, g, h);
+    case highpass: return tick<highpass>(inputSample, z1, z2, g, h);
+    default:       return tick<lowpass>(inputSample, z1, z2, g, h);
+    }
+}
@@ -11,17 +11,59 @@
 #pragma once
 #include <JuceHeader.h>
 
+// filtr stanowy TPT (jak juce::dsp::StateVariableTPTFilter, te same wzory) z modulacja odciecia w tempie kontrolnym:
+// wspolczynniki co controlInterval probek z tablicy odciecie -> g (bez tan), pomiedzy punktami liniowo
 class FilterData
 {
 public:
+    static constexpr int controlInterval = 16;
+
     void prepareToPlay(double sampleRate, int samplesPerBlock, int numChannels);
     void process(juce::AudioBuffer<float>& buffer);
-    void updateParameters(int filterType, float baseCutoff, float resonance, float envValue = 0.0f);
+    // false = te same wejscia co ostatnio, wspolczynniki bez zmian
+    bool updateParameters(int filterType, float baseCutoff, float resonance, float envValue = 0.0f);
+    // typ i rezonans, odciecie z processBlock
+    void setTypeAndResonance(int filterType, float resonance);
+    // kanal 0 w miejscu, odciecie baseCutoff + envValue * (20 kHz - baseCutoff) na probke,
+    // zwraca ile razy policzono nowe wspolczynniki
+    int processBlock(float* samples, const float* baseCutoff, const float* envValue, int numSamples);
+    // wszystkie kanaly bloku z tymi samymi wspolczynnikami (wspolny filtr po miksie glosow)
+    int processBlock(juce::dsp::AudioBlock<float> block, const float* baseCutoff, const float* envValue);
     void reset();
     float processSample(int channel, float inputSample);
 
 private:
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    enum Type { lowpass = 0, bandpass, highpass };
+
+    static float getModulatedCutoff(float baseCutoff, float envValue) noexcept
+    {
+        return juce::jlimit(20.0f, 20000.0f, baseCutoff + envValue * (20000.0f - baseCutoff));
+    }
+
+    float getG(float cutoff) const noexcept;
+    void setCutoff(float cutoff) noexcept;
+    template <int FilterType>
+    int processChannels(juce::dsp::AudioBlock<float>& block, const float* baseCutoff, const float* envValue) noexcept;
+    template <int FilterType>
+    float tick(float input, float& z1, float& z2, float gain, float normalisation) const noexcept;
+
     bool isPrepared{ false };
+    double sampleRate{ 44100.0 };
+
+    // g = tan(pi * f / fs) co gTableStep Hz do 20 kHz - liniowo miedzy punktami blad ponizej 1e-5
+    static constexpr float gTableStep = 20.0f;
+    std::vector<float> gTable;
+
+    int type{ lowpass };
+    float R2{ juce::MathConstants<float>::sqrt2 };
+    float g{ 0.0f }, h{ 1.0f };
+    float currentCutoff{ -1.0f };   // -1 = po reset, pierwszy punkt bez rampy
+    std::vector<float> s1, s2;
+
+    // ostatnie wejscia updateParameters, type -1 = jeszcze nie ustawione
+    int lastType{ -1 };
+    float lastCutoff{ 0.0f };
+    float lastResonance{ 0.0f };
+    float lastEnvValue{ 0.0f };
 
 };
@@ -0,0 +1,575 @@
+/*
+  ==============================================================================
+
+    OperatorKernel.h
+    Created: 17 Oct 2026 1:05:12pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// faza jako 32-bitowy licznik staloprzecinkowy: pelny okres = 2^32, zawijanie za darmo przez przepelnienie
+#if JUCE_USE_SIMD
+template <typename Vec>
+using PhaseVector = std::conditional_t<std::is_same_v<Vec, float>, juce::uint32, juce::dsp::SIMDRegister<juce::uint32>>;
+#else
+template <typename Vec>
+using PhaseVector = juce::uint32;
+#endif
+
+// stan operatora dla kilku glosow naraz (struktura tablic), Lanes = 1 dla jednego glosu
+template <int Lanes>
+struct OperatorState
+{
+    alignas(sizeof(float) * Lanes) juce::uint32 phase[Lanes] = {};
+    alignas(sizeof(float) * Lanes) juce::uint32 phaseIncrement[Lanes] = {};
+    alignas(sizeof(float) * Lanes) float modulationHP[Lanes] = {};
+    alignas(sizeof(float) * Lanes) float prevModulation[Lanes] = {};
+    alignas(sizeof(float) * Lanes) float gain[Lanes] = {};
+    alignas(sizeof(float) * Lanes) float lastOutput[Lanes] = {};     // ostatnia probka dla sprzezenia
+};
+
+// stan operatora w rejestrach na czas bloku (float albo SIMDRegister)
+template <typename Vec>
+struct OperatorRegisters
+{
+    PhaseVector<Vec> phase, increment;
+    Vec hp, prev, gain, coefficient, scale;
+    Vec width, inverseWidth;    // przyrost fazy w okresach (0-0.5) dla PolyBLEP/PolyBLAMP i jego odwrotnosc
+};
+
+// tablica sinusa wspolna dla wszystkich operatorow, wypelniana przy starcie programu, potem tylko do odczytu
+struct SineTable
+{
+    static constexpr int bits = 11;     // indeks = gorne bity fazy
+    static constexpr int size = 1 << bits;
+    float values[size + 1];     // ostatni punkt = pierwszy, interpolacja bez zawijania indeksu
+
+    SineTable()
+    {
+        for (int i = 0; i <= size; ++i)
+            values[i] = (float)std::sin(juce::MathConstants<double>::twoPi * i / size);
+    }
+};
+
+inline const SineTable sineTable;
+
+class OperatorKernel
+{
+public:
+    // ile glosow naraz - szerokosc rejestru SIMD (SSE/NEON 4, AVX 8)
+   #if JUCE_USE_SIMD
+    using LaneVector = juce::dsp::SIMDRegister<float>;
+    using PhaseLaneVector = juce::dsp::SIMDRegister<juce::uint32>;
+    static constexpr int numLanes = (int)LaneVector::SIMDNumElements;
+   #else
+    static constexpr int numLanes = 1;
+   #endif
+
+    // typ jednej probki dla Lanes glosow
+   #if JUCE_USE_SIMD
+    template <int Lanes>
+    using VectorType = std::conditional_t<Lanes == 1, float, LaneVector>;
+   #else
+    template <int Lanes>
+    using VectorType = float;
+   #endif
+
+    // dokladnosc sinusa i trojkata, wybierana dla kazdego OscData
+    // maksymalny blad wzgledem ksztaltu liczonego w double z fazy licznika: sinus / trojkat
+    // (exact i wielomian ograniczone przez faze w radianach jako float)
+    // koszt w ns na probke operatora z modulacja FM (Tests/Benchmarks/PrecisionBenchmark, gcc -O3, SSE, 1 rdzen):
+    //   pojedynczy glos: sinus exact 12-15 / wielomian 8-10 / tablica 5, trojkat exact 23-30 / wielomian i tablica 6-7,
+    //   pila i kwadrat 4-5.5 niezaleznie od dokladnosci (nie licza sinusa, roznice miedzy poziomami to szum pomiaru)
+    //   grupa glosow (na glos): 1.2-2.6 dla wszystkich ksztaltow i poziomow, exact liczony tam wielomianem
+    enum Precision
+    {
+        exactPrecision = 0,     // std::sin/std::asin jak dotad: 5.9e-7 / 1.6e-4 (asin przy szczytach)
+        polynomialPrecision,    // wielomian 9 stopnia, trojkat liniowo: 4.3e-7 / 6.0e-7
+        tablePrecision,         // tablica 2048 punktow (gorne bity fazy) + interpolacja liniowa, trojkat liniowo: 1.2e-6 / 6.0e-7
+        numPrecisions
+    };
+
+    // ksztalty liczone w kernelu: WAVETYPE 0-3 i pila/kwadrat/trojkat z korekcja PolyBLEP/PolyBLAMP
+    enum Wave
+    {
+        sineWave = 0,
+        sawWave,
+        squareWave,
+        triangleWave,
+        bandLimitedSawWave,
+        bandLimitedSquareWave,
+        bandLimitedTriangleWave,
+        numWaves
+    };
+
+    // jak modulacja wchodzi do operatora, wybierane dla calego patcha
+    enum ModulationMode
+    {
+        frequencyModulation = 0,    // modulacja (po DC-blokerze) dodawana do przyrostu fazy co probke
+        phaseModulation,            // jak w DX7: modulacja przesuwa tylko odczyt ksztaltu, bez DC-blokera
+        numModulationModes
+    };
+
+    // nieznany ksztalt liczony jest jak sinus
+    static constexpr int getWave(int waveType, bool bandLimited) noexcept
+    {
+        if (waveType < sawWave || waveType > triangleWave)
+            return sineWave;
+        return bandLimited ? waveType + (bandLimitedSawWave - sawWave) : waveType;
+    }
+
+    static float phaseToRadians(juce::uint32 phase) noexcept
+    {
+        return (float)phase * (juce::MathConstants<float>::twoPi / 4294967296.0f);
+    }
+
+    // glosy w rejestrze SIMD nie maja std::sin - exact liczony jest tam wielomianem
+    template <typename Vec, int Precision>
+    static constexpr int effectivePrecision = (Precision == exactPrecision && !std::is_same_v<Vec, float>)
+        ? (int)polynomialPrecision : Precision;
+
+    // Lanes == 1: jeden glos, Lanes == numLanes: glosy w rejestrze SIMD
+    // modulation, env i output ulozone [probka][glos] i wyrownane do rejestru; modulation == nullptr to brak modulacji
+    template <int Lanes>
+    static void process(OperatorState<Lanes>& state, int wave, int precision, int mode, float dcBlockerCoefficient,
+        float modulationScale, const float* modulation, const float* env, float* output, int numSamples)
+    {
+        using Vec = VectorType<Lanes>;
+        static_assert(Lanes == 1 || Lanes == numLanes, "grupa glosow musi miec szerokosc rejestru");
+
+        switch (precision)
+        {
+        case polynomialPrecision: processMode<Vec, polynomialPrecision>(state, wave, mode, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case tablePrecision:      processMode<Vec, tablePrecision>(state, wave, mode, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        default:                  processMode<Vec, exactPrecision>(state, wave, mode, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        }
+    }
+
+    template <int Lanes>
+    static void loadLane(OperatorState<Lanes>& lanes, int lane, const OperatorState<1>& voice) noexcept
+    {
+        lanes.phase[lane] = voice.phase[0];
+        lanes.phaseIncrement[lane] = voice.phaseIncrement[0];
+        lanes.modulationHP[lane] = voice.modulationHP[0];
+        lanes.prevModulation[lane] = voice.prevModulation[0];
+        lanes.gain[lane] = voice.gain[0];
+        lanes.lastOutput[lane] = voice.lastOutput[0];
+    }
+
+    // operator bez wkladu w bloku (FMAlgorithmRouter::findPrunedOperators): bez liczenia probek faza idzie dalej
+    // o przyrost * liczba probek (licznik sam sie zawija), wiec po powrocie gra dalej w tej samej fazie
+    template <int Lanes>
+    static void skip(OperatorState<Lanes>& state, int numSamples) noexcept
+    {
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            state.phase[lane] += state.phaseIncrement[lane] * (juce::uint32)numSamples;
+            state.lastOutput[lane] = 0.0f;
+        }
+    }
+
+    template <int Lanes>
+    static void storeLane(const OperatorState<Lanes>& lanes, int lane, OperatorState<1>& voice) noexcept
+    {
+        voice.phase[0] = lanes.phase[lane];
+        voice.modulationHP[0] = lanes.modulationHP[lane];
+        voice.prevModulation[0] = lanes.prevModulation[lane];
+        voice.lastOutput[0] = lanes.lastOutput[lane];
+    }
+
+    // sinus dla fazy 0-2pi, wielomian 9 stopnia na cwiartce
+    template <typename Vec>
+    static inline Vec fastSin(Vec phase) noexcept
+    {
+        const float pi = juce::MathConstants<float>::pi;
+
+        // sin(pi - x) = sin(x), odbicia do -pi/2..pi/2 przez min/max zamiast warunkow
+        Vec x = splat<Vec>(pi) - phase;
+        x = vmin(x, splat<Vec>(pi) - x);
+        x = vmax(x, splat<Vec>(-pi) - x);
+
+        const Vec x2 = x * x;
+        return x * (splat<Vec>(0.9999999766f) + x2 * (splat<Vec>(-0.1666664764f) + x2 * (splat<Vec>(0.0083328999f)
+            + x2 * (splat<Vec>(-0.0001980090f) + x2 * splat<Vec>(2.5904939e-6f)))));
+    }
+
+    // sinus z tablicy: gorne bity fazy to indeks, reszta to ulamek do interpolacji liniowej
+    template <typename Vec>
+    static inline Vec tableSin(PhaseVector<Vec> phase) noexcept
+    {
+        constexpr int fractionBits = 32 - SineTable::bits;
+        constexpr juce::uint32 fractionMask = (1u << fractionBits) - 1;
+        constexpr float fractionScale = 1.0f / (float)(1u << fractionBits);
+
+        if constexpr (std::is_same_v<Vec, float>)
+        {
+            const float* y = sineTable.values + (phase >> fractionBits);
+            return y[0] + (float)(phase & fractionMask) * fractionScale * (y[1] - y[0]);
+        }
+       #if JUCE_USE_SIMD
+        else
+        {
+            // SSE/NEON nie maja gather - punkty tablicy pojedynczo, ulamek i interpolacja w rejestrze
+            alignas(sizeof(Vec)) juce::uint32 phases[numLanes];
+            alignas(sizeof(Vec)) float y0[numLanes], y1[numLanes];
+            phase.copyToRawArray(phases);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const float* y = sineTable.values + (phases[lane] >> fractionBits);
+                y0[lane] = y[0];
+                y1[lane] = y[1];
+            }
+
+            const Vec fraction = toFloat(phase & PhaseLaneVector::expand(fractionMask)) * (2.0f * fractionScale);
+            const Vec v0 = Vec::fromRawArray(y0);
+            return v0 + fraction * (Vec::fromRawArray(y1) - v0);
+        }
+       #endif
+    }
+
+    // PolyBLEP/PolyBLAMP: t = faza od nieciaglosci w okresach, 1 - odleglosc od niej w probkach obcieta do zera,
+    // poza probka przy nieciaglosci obie czesci sa zerem - bez warunkow
+    template <typename Vec>
+    static inline Vec afterEdge(Vec t, Vec inverseWidth) noexcept
+    {
+        return vmax(splat<Vec>(0.0f), splat<Vec>(1.0f) - t * inverseWidth);
+    }
+
+    template <typename Vec>
+    static inline Vec beforeEdge(Vec t, Vec inverseWidth) noexcept
+    {
+        return vmax(splat<Vec>(0.0f), splat<Vec>(1.0f) - (splat<Vec>(1.0f) - t) * inverseWidth);
+    }
+
+    // faza licznika w okresach 0-1
+    template <typename Vec>
+    static inline Vec toCycles(PhaseVector<Vec> phase) noexcept
+    {
+        if constexpr (std::is_same_v<Vec, float>)
+            return (float)phase * (1.0f / 4294967296.0f);
+       #if JUCE_USE_SIMD
+        else
+            return toFloat(phase) * (1.0f / 2147483648.0f);
+       #endif
+    }
+
+    // faza licznika w radianach 0-2pi
+    template <typename Vec>
+    static inline Vec toRadians(PhaseVector<Vec> phase) noexcept
+    {
+        if constexpr (std::is_same_v<Vec, float>)
+            return phaseToRadians(phase);
+       #if JUCE_USE_SIMD
+        else
+            return toFloat(phase) * (juce::MathConstants<float>::twoPi / 2147483648.0f);
+       #endif
+    }
+
+    // przesuniecie fazy z modulacji (radiany, dowolnie duze) w jednostkach licznika, modulo pelny okres
+    template <typename Vec>
+    static inline PhaseVector<Vec> toPhaseOffset(Vec radians) noexcept
+    {
+        constexpr float invTwoPi = 1.0f / juce::MathConstants<float>::twoPi;
+
+        // ulamek okresu -1..1 miesci sie w int32 jako ulamek * 2^31, podwojenie = * 2^32
+        const Vec cycles = radians * invTwoPi;
+        const PhaseVector<Vec> half = truncateToPhase((cycles - vtrunc(cycles)) * 2147483648.0f);
+        return half + half;
+    }
+
+    template <typename Vec, int Lanes>
+    static inline OperatorRegisters<Vec> loadRegisters(const OperatorState<Lanes>& state,
+        float dcBlockerCoefficient, float modulationScale) noexcept
+    {
+        // szerokosc korekcji z przyrostu bez modulacji, raz na blok (SIMDRegister nie ma dzielenia)
+        alignas(sizeof(float) * Lanes) float width[Lanes], inverseWidth[Lanes];
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            const float cycles = (float)state.phaseIncrement[lane] * (1.0f / 4294967296.0f);
+            width[lane] = juce::jlimit(1.0e-6f, 0.5f, juce::jmin(cycles, 1.0f - cycles));
+            inverseWidth[lane] = 1.0f / width[lane];
+        }
+
+        return { loadPhase<Vec>(state.phase), loadPhase<Vec>(state.phaseIncrement), load<Vec>(state.modulationHP),
+                 load<Vec>(state.prevModulation), load<Vec>(state.gain),
+                 splat<Vec>(dcBlockerCoefficient), splat<Vec>(modulationScale),
+                 load<Vec>(width), load<Vec>(inverseWidth) };
+    }
+
+    template <typename Vec, int Lanes>
+    static inline void storeRegisters(const OperatorRegisters<Vec>& registers, OperatorState<Lanes>& state) noexcept
+    {
+        store(state.phase, registers.phase);
+        store(state.modulationHP, registers.hp);
+        store(state.prevModulation, registers.prev);
+    }
+
+    // jedna probka operatora, wspolna dla petli operatora i calego lancucha algorytmu
+    template <typename Vec, int WaveType, int Precision, int Mode>
+    static inline Vec tick(OperatorRegisters<Vec>& r, Vec modulation, Vec env) noexcept
+    {
+        if constexpr (Mode == phaseModulation)
+        {
+            // licznik idzie rowno, modulacja (radiany * indeks) tylko przesuwa odczyt - stan HP nieuzywany
+            r.phase = r.phase + r.increment;
+
+            return waveform<Vec, WaveType, effectivePrecision<Vec, Precision>>(r,
+                r.phase + toPhaseOffset(modulation * r.scale)) * r.gain * env;
+        }
+        else
+        {
+            // DC-bloker aby zapobiec zmianom czestotliwosci
+            r.hp = r.coefficient * (r.hp + modulation - r.prev);
+            r.prev = modulation;
+
+            // faza z odfiltrowana modulacja, licznik zawija sie sam - w petli zostaje tylko dodawanie calkowite
+            r.phase = r.phase + r.increment + toPhaseOffset(r.hp * r.scale);
+
+            return waveform<Vec, WaveType, effectivePrecision<Vec, Precision>>(r, r.phase) * r.gain * env;
+        }
+    }
+
+    // te same operacje dla float i rejestru SIMD
+    template <typename Vec>
+    static inline Vec splat(float value) noexcept
+    {
+       #if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<Vec, LaneVector>)
+            return LaneVector::expand(value);
+        else
+       #endif
+            return value;
+    }
+
+    template <typename Vec>
+    static inline Vec load(const float* p) noexcept
+    {
+       #if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<Vec, LaneVector>)
+            return LaneVector::fromRawArray(p);
+        else
+       #endif
+            return *p;
+    }
+
+    template <typename Vec>
+    static inline PhaseVector<Vec> splatPhase(juce::uint32 value) noexcept
+    {
+       #if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<Vec, LaneVector>)
+            return PhaseLaneVector::expand(value);
+        else
+       #endif
+            return value;
+    }
+
+    template <typename Vec>
+    static inline PhaseVector<Vec> loadPhase(const juce::uint32* p) noexcept
+    {
+       #if JUCE_USE_SIMD
+        if constexpr (std::is_same_v<Vec, LaneVector>)
+            return PhaseLaneVector::fromRawArray(p);
+        else
+       #endif
+            return *p;
+    }
+
+    static inline void store(float* p, float v) noexcept { *p = v; }
+    static inline void store(juce::uint32* p, juce::uint32 v) noexcept { *p = v; }
+    static inline float vmin(float a, float b) noexcept { return std::min(a, b); }
+    static inline float vmax(float a, float b) noexcept { return std::max(a, b); }
+    static inline float vabs(float a) noexcept { return std::abs(a); }
+    static inline float vtrunc(float a) noexcept { return (float)(int)a; }
+    static inline juce::uint32 truncateToPhase(float a) noexcept { return (juce::uint32)(juce::int32)a; }
+    // a >= b ? value : 0
+    static inline float ifGreaterOrEqual(float a, float b, float value) noexcept { return a >= b ? value : 0.0f; }
+
+   #if JUCE_USE_SIMD
+    static inline void store(float* p, LaneVector v) noexcept { v.copyToRawArray(p); }
+    static inline void store(juce::uint32* p, PhaseLaneVector v) noexcept { v.copyToRawArray(p); }
+    static inline LaneVector vmin(LaneVector a, LaneVector b) noexcept { return LaneVector::min(a, b); }
+    static inline LaneVector vmax(LaneVector a, LaneVector b) noexcept { return LaneVector::max(a, b); }
+    static inline LaneVector vabs(LaneVector a) noexcept { return LaneVector::abs(a); }
+    static inline LaneVector vtrunc(LaneVector a) noexcept { return LaneVector::truncate(a); }
+    static inline LaneVector ifGreaterOrEqual(LaneVector a, LaneVector b, float value) noexcept
+    {
+        return LaneVector::expand(value) & LaneVector::greaterThanOrEqual(a, b);
+    }
+
+    // SIMDRegister nie ma konwersji float <-> int, ta sama natywna instrukcja co w SIMDNativeOps danej platformy
+    static inline PhaseLaneVector truncateToPhase(LaneVector a) noexcept
+    {
+       #if JUCE_INTEL && defined(__AVX2__)
+        return PhaseLaneVector::fromNative(_mm256_cvttps_epi32(a.value));
+       #elif JUCE_INTEL
+        return PhaseLaneVector::fromNative(_mm_cvttps_epi32(a.value));
+       #elif JUCE_ARM
+        return PhaseLaneVector::fromNative(vreinterpretq_u32_s32(vcvtq_s32_f32(a.value)));
+       #else
+        alignas(sizeof(LaneVector)) float values[numLanes];
+        alignas(sizeof(LaneVector)) juce::uint32 phases[numLanes];
+        a.copyToRawArray(values);
+        for (int lane = 0; lane < numLanes; ++lane)
+            phases[lane] = (juce::uint32)(juce::int32)values[lane];
+        return PhaseLaneVector::fromRawArray(phases);
+       #endif
+    }
+
+    // polowa licznika (0..2^31) jako float - konwersja ze znakiem wystarcza na kazdej platformie
+    static inline LaneVector toFloat(PhaseLaneVector phase) noexcept
+    {
+       #if JUCE_INTEL && defined(__AVX2__)
+        return LaneVector::fromNative(_mm256_cvtepi32_ps(_mm256_srli_epi32(phase.value, 1)));
+       #elif JUCE_INTEL
+        return LaneVector::fromNative(_mm_cvtepi32_ps(_mm_srli_epi32(phase.value, 1)));
+       #elif JUCE_ARM
+        return LaneVector::fromNative(vcvtq_f32_u32(vshrq_n_u32(phase.value, 1)));
+       #else
+        alignas(sizeof(LaneVector)) juce::uint32 phases[numLanes];
+        alignas(sizeof(LaneVector)) float values[numLanes];
+        phase.copyToRawArray(phases);
+        for (int lane = 0; lane < numLanes; ++lane)
+            values[lane] = (float)(phases[lane] >> 1);
+        return LaneVector::fromRawArray(values);
+       #endif
+    }
+   #endif
+
+private:
+    template <typename Vec, int Precision, int Lanes>
+    static void processMode(OperatorState<Lanes>& state, int wave, int mode, float dcBlockerCoefficient, float modulationScale,
+        const float* modulation, const float* env, float* output, int numSamples)
+    {
+        if (mode == phaseModulation)
+            processWave<Vec, Precision, phaseModulation>(state, wave, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples);
+        else
+            processWave<Vec, Precision, frequencyModulation>(state, wave, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples);
+    }
+
+    template <typename Vec, int Precision, int Mode, int Lanes>
+    static void processWave(OperatorState<Lanes>& state, int wave, float dcBlockerCoefficient, float modulationScale,
+        const float* modulation, const float* env, float* output, int numSamples)
+    {
+        switch (wave)
+        {
+        case sawWave:                 processLanes<Vec, sawWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case squareWave:              processLanes<Vec, squareWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case triangleWave:            processLanes<Vec, triangleWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case bandLimitedSawWave:      processLanes<Vec, bandLimitedSawWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case bandLimitedSquareWave:   processLanes<Vec, bandLimitedSquareWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        case bandLimitedTriangleWave: processLanes<Vec, bandLimitedTriangleWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        default:                      processLanes<Vec, sineWave, Precision, Mode>(state, dcBlockerCoefficient, modulationScale, modulation, env, output, numSamples); break;
+        }
+    }
+
+    // ksztalt w punkcie licznika phase (FM: r.phase, PM: r.phase przesuniete o modulacje)
+    template <typename Vec, int WaveType, int Precision>
+    static inline Vec waveform(const OperatorRegisters<Vec>& r, PhaseVector<Vec> phase) noexcept
+    {
+        constexpr bool exact = Precision == exactPrecision;
+        constexpr float pi = juce::MathConstants<float>::pi;
+        constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+        // ksztalt naiwny + poprawka tylko w probce przy skoku albo zalamaniu, bez dodatkowych buforow
+        if constexpr (WaveType >= bandLimitedSawWave)
+        {
+            constexpr int naiveWave = WaveType - (bandLimitedSawWave - sawWave);
+            return bandLimit<Vec, naiveWave>(r, phase, waveform<Vec, naiveWave, Precision>(r, phase));
+        }
+        // tablica bierze indeks prosto z licznika, reszta ksztaltow liczy w radianach
+        else if constexpr (WaveType == sineWave && Precision == tablePrecision)
+        {
+            return tableSin<Vec>(phase);
+        }
+        else
+        {
+            const Vec radians = toRadians<Vec>(phase);
+
+            if constexpr (WaveType == sawWave)
+            {
+                if constexpr (exact)
+                    return 1.0f - 2.0f * (radians / twoPi);
+                else
+                    return splat<Vec>(1.0f) - radians * (2.0f / twoPi);
+            }
+            else if constexpr (WaveType == squareWave)
+                return splat<Vec>(1.0f) - ifGreaterOrEqual(radians, splat<Vec>(pi), 2.0f);
+            else if constexpr (WaveType == triangleWave)
+            {
+                if constexpr (exact)
+                    return (2.0f / pi) * std::asin(std::sin(radians));
+
+                // to samo co asin(sin) ale liniowo: 0 -> 1 -> 0 -> -1 -> 0
+                Vec u = radians * (2.0f / pi) + 1.0f;
+                u = u - ifGreaterOrEqual(u, splat<Vec>(4.0f), 4.0f);
+                return splat<Vec>(1.0f) - vabs(u - 2.0f);
+            }
+            else // sine
+            {
+                if constexpr (exact)
+                    return std::sin(radians);
+                else
+                    return fastSin(radians);
+            }
+        }
+    }
+
+    template <typename Vec, int WaveType>
+    static inline Vec bandLimit(const OperatorRegisters<Vec>& r, PhaseVector<Vec> phase, Vec naive) noexcept
+    {
+        if constexpr (WaveType == sawWave)
+        {
+            // skok z -1 na 1 na poczatku okresu
+            const Vec t = toCycles<Vec>(phase);
+            const Vec after = afterEdge(t, r.inverseWidth);
+            const Vec before = beforeEdge(t, r.inverseWidth);
+            return naive + before * before - after * after;
+        }
+        else if constexpr (WaveType == squareWave)
+        {
+            // skoki w 0 i w 1/2 okresu naraz: faza podwojona (przepelnienie) ma skok w 0, znak skoku = znak ksztaltu
+            const Vec t = toCycles<Vec>(phase + phase);
+            const Vec inverseWidth = r.inverseWidth * 0.5f;
+            const Vec after = afterEdge(t, inverseWidth);
+            const Vec before = beforeEdge(t, inverseWidth);
+            return naive * (splat<Vec>(1.0f) - after * after - before * before);
+        }
+        else
+        {
+            // trojkat: nachylenie zmienia sie o -8 w 1/4 i o +8 w 3/4 okresu (na probke * szerokosc);
+            // od szczytu w 1/4 okresu: pierwsza polowa opada, druga rosnie, oba zalamania w podwojonej fazie w 0
+            const Vec c = toCycles<Vec>(phase - splatPhase<Vec>(1u << 30));
+            const Vec rising = ifGreaterOrEqual(c, splat<Vec>(0.5f), 1.0f);
+            const Vec t = c + c - rising;
+            const Vec inverseWidth = r.inverseWidth * 0.5f;
+            const Vec after = afterEdge(t, inverseWidth);
+            const Vec before = beforeEdge(t, inverseWidth);
+            const Vec sign = rising + rising - 1.0f;
+            return naive + sign * (after * after * after - before * before * before) * r.width * (8.0f / 6.0f);
+        }
+    }
+
+    template <typename Vec, int WaveType, int Precision, int Mode, int Lanes>
+    static void processLanes(OperatorState<Lanes>& state, float dcBlockerCoefficient, float modulationScale,
+        const float* modulation, const float* env, float* output, int numSamples)
+    {
+        // caly stan w rejestrach na czas bloku
+        auto registers = loadRegisters<Vec>(state, dcBlockerCoefficient, modulationScale);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const Vec m = (modulation != nullptr) ? load<Vec>(modulation + i * Lanes) : splat<Vec>(0.0f);
+            store(output + i * Lanes, tick<Vec, WaveType, Precision, Mode>(registers, m, load<Vec>(env + i * Lanes)));
+        }
+
+        storeRegisters(registers, state);
+    }
+};
@@ -14,7 +14,59 @@ void OscData::prepareToPlay(juce::dsp::ProcessSpec& spec)
 {
     sampleRate = spec.sampleRate;
     // domsylnie brak fazy zresetuj na start
-    currentPhase = 0.0f;
+    state.phase[0] = 0;
+    phaseFraction = 0;
+
+    updateDcBlocker();
+    gainRamp.setRampLength(sampleRate * oversamplingFactor, gainRampSeconds);
+}
+
+void OscData::setGainRampTime(double newRampSeconds)
+{
+    gainRampSeconds = newRampSeconds;
+    gainRamp.setRampLength(sampleRate * oversamplingFactor, gainRampSeconds);
+}
+
+void OscData::updateDcBlocker()
+{
+    // DC-bloker modulacji (HPF 1. rzedu, 40 Hz) aby zapobiec zmianom czestotliwosci
+    const double operatorRate = sampleRate * oversamplingFactor;
+    const double cutoff = juce::MathConstants<double>::twoPi * 40.0;
+    dcBlockerCoefficient = (float)(operatorRate / (operatorRate + cutoff));
+}
+
+void OscData::setOversamplingFactor(int newFactor)
+{
+    oversamplingFactor = juce::jmax(1, newFactor);
+
+    updateModulationScale();
+    updateDcBlocker();
+    updatePhaseIncrement(getFrequency());
+
+    // rampa gainu liczona na probkach operatora
+    gainRamp.setRampLength(sampleRate * oversamplingFactor, gainRampSeconds);
+}
+
+void OscData::setModulationMode(int newMode)
+{
+    modulationMode = juce::jlimit(0, OperatorKernel::numModulationModes - 1, newMode);
+    updateModulationScale();
+}
+
+void OscData::setModulationIndex(float newIndex)
+{
+    modulationIndex = juce::jmax(0.0f, newIndex);
+    updateModulationScale();
+}
+
+void OscData::updateModulationScale()
+{
+    // FM: modulacja dodawana do fazy co probke - przy factor razy wiecej probek factor razy mniejsza
+    // PM: przesuniecie fazy nie zalezy od liczby probek
+    if (modulationMode == OperatorKernel::phaseModulation)
+        modulationScale = modulationIndex;
+    else
+        modulationScale = modulationDepth * modulationIndex / (float)oversamplingFactor;
 }
 
 void OscData::setWaveType(int choice)
@@ -29,55 +81,26 @@ void OscData::setBaseFrequency(float freq)
 
 void OscData::updatePhaseIncrement(float freq)
 {
-    // przelicz hz na increment fazy (radiany/sample)
-    phaseIncrement = (freq / (float)sampleRate) * juce::MathConstants<float>::twoPi;
+    // przelicz hz na increment fazy (czesc okresu * 2^32 na sample), reszta ponizej kroku do incrementFraction
+    const double cycles = freq / (sampleRate * oversamplingFactor);
+    const double units = (cycles - std::floor(cycles)) * 4294967296.0;
+    const double whole = std::floor(units);
+
+    state.phaseIncrement[0] = (juce::uint32)(juce::uint64)whole;
+    incrementFraction = (juce::uint32)((units - whole) * 4294967296.0);
 }
 
 float OscData::getModulatedSample(float modulation, float modEnv)
 {
-    // DC-bloker aby zapobiec zmianom czestotliwosci
-    float freq = juce::MathConstants<float>::twoPi * 40;
-    const float alpha = (sampleRate - freq )/freq; 
-    modulationHP = alpha * (modulationHP + modulation - prevModulation);
-    prevModulation = modulation;
-
-    // skala modulacji (indeks FM)
-    float modulationIndex = modulationScale;
-
-    // aktualizacja fazy z uwzgl odfiltrowanej modulacji
-    float fm = modulationHP * modulationIndex;
-    currentPhase += phaseIncrement + fm;
-
-    // zawijanie fazy do 0, 2pi
-    currentPhase = std::fmod(currentPhase, juce::MathConstants<float>::twoPi);
-    if (currentPhase < 0.0f)
-        currentPhase += juce::MathConstants<float>::twoPi;
-     
-    
-
-    // generacja probki zgodnie z typem fali
     float sample = 0.0f;
-    switch (waveType)
-    {
-    case 0: // sine
-        sample = std::sin(currentPhase);
-        break;
-    case 1: // saw
-        sample = 1.0f - 2.0f * (currentPhase / juce::MathConstants<float>::twoPi);
-        break;
-    case 2: // square
-        sample = (currentPhase < juce::MathConstants<float>::pi) ? 1.0f : -1.0f;
-        break;
-    case 3: // triangle
-        sample = (2.0f / juce::MathConstants<float>::pi) * std::asin(std::sin(currentPhase));
-        break;
-    default:
-        sample = std::sin(currentPhase);
-        break;
-    }
-
-    // zwracamy probke pomnożoną przez gain i obwiednie
-    return sample * gain * modEnv;
+    processBlock(&modulation, &modEnv, &sample, 1);
+    return sample;
+}
+
+void OscData::processBlock(const float* modulation, const float* modEnv, float* output, int numSamples)
+{
+    OperatorKernel::process(state, getKernelWave(), precision, modulationMode, dcBlockerCoefficient, modulationScale,
+        modulation, modEnv, output, numSamples);
 }
 
 
@@ -87,6 +110,5 @@ void OscData::setBaseFreqParams(float newBaseFreq, float newCoarse, float newFin
     noteBaseFrequency = newBaseFreq;
     coarse = newCoarse;
     fine = newFine;
-    float freq = noteBaseFrequency * (coarse + fine * 0.001f);
-    updatePhaseIncrement(freq);
+    updatePhaseIncrement(getFrequency());
 }
@@ -10,47 +10,117 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "OperatorKernel.h"
+#include "ParameterRamp.h"
 
 class OscData
 {
 public:
     void prepareToPlay(juce::dsp::ProcessSpec& spec);
     void setWaveType(int choice);
+    // pila/kwadrat/trojkat z korekcja PolyBLEP/PolyBLAMP, false = ksztalty naiwne (porownanie aliasingu i CPU)
+    void setBandLimited(bool shouldBeBandLimited) { bandLimited = shouldBeBandLimited; }
+    // OperatorKernel::exactPrecision / polynomialPrecision / tablePrecision
+    void setPrecision(int newPrecision) { precision = juce::jlimit(0, OperatorKernel::numPrecisions - 1, newPrecision); }
     void setCoarse(float newCoarse) { coarse = newCoarse; }
     void setFine(float newFine) { fine = newFine; }
-    void setGain(float newGain) { gain = newGain; }
+    // zmiana gainu w trakcie nuty wygladzana rampa (applyGainRamp), nowa nuta od razu z nowym (skipGainRamp)
+    void setGain(float newGain) { gainRamp.setTargetValue(newGain); }
+    void setGainRampTime(double newRampSeconds);
+    void skipGainRamp() { gainRamp.skip(); }
+    // raz na blok, na tablicy obwiedni operatora: w trakcie rampy gain probka po probce w obwiedni
+    // (kernel mnozy przez 1), poza rampa stala w kernelu jak dotad
+    void applyGainRamp(float* env, int numSamples)
+    {
+        if (gainRamp.isSmoothing())
+        {
+            gainRamp.applyGain(env, numSamples);
+            state.gain[0] = 1.0f;
+        }
+        else
+            state.gain[0] = gainRamp.getTargetValue();
+    }
     void setBaseFrequency(float freq);
     void setBaseFreqParams(float newBaseFreq, float newCoarse, float newFine);
+    // operator liczony factor razy szybciej niz host (OversamplingData) - przyrost, DC-bloker i skala modulacji
+    // przeliczone tak, zeby brzmienie (dewiacja w Hz) nie zalezalo od faktoru
+    void setOversamplingFactor(int newFactor);
+    // OperatorKernel::frequencyModulation / phaseModulation
+    void setModulationMode(int newMode);
+    // czulosc operatora na modulacje: FM - mnoznik dewiacji (1 = jak dotad), PM - przesuniecie fazy w radianach
+    // na jednostke modulacji
+    void setModulationIndex(float newIndex);
 
     float getModulatedSample(float modulation, float modEnv = 1.0f);
-    void resetPhase() { currentPhase = 0.0f; }
-    float getPhase() const { return currentPhase; }
+    // caly blok naraz, modulation == nullptr oznacza brak modulacji
+    void processBlock(const float* modulation, const float* modEnv, float* output, int numSamples);
+    void resetPhase() { state.phase[0] = 0; phaseFraction = 0; }
+    // faza w radianach (licznik fazy w getState().phase)
+    float getPhase() const { return OperatorKernel::phaseToRadians(state.phase[0]); }
 
     float getCoarse() const { return coarse; }
     float getFine() const { return fine; }
-    float getGain() const { return gain; }
+    float getGain() const { return gainRamp.getTargetValue(); }
+    int getWaveType() const { return waveType; }
+    bool isBandLimited() const { return bandLimited; }
+    // ksztalt liczony w kernelu (OperatorKernel::Wave)
+    int getKernelWave() const { return OperatorKernel::getWave(waveType, bandLimited); }
+    int getPrecision() const { return precision; }
+    int getModulationMode() const { return modulationMode; }
+    float getModulationIndex() const { return modulationIndex; }
+    float getDcBlockerCoefficient() const { return dcBlockerCoefficient; }
+    float getModulationScale() const { return modulationScale; }
+    int getOversamplingFactor() const { return oversamplingFactor; }
+    // czestotliwosc operatora i dewiacja FM w Hz na jednostke modulacji (do oceny szerokosci widma glosu)
+    float getFrequency() const { return noteBaseFrequency * (coarse + fine * 0.001f); }
+    float getFrequencyDeviation() const { return (float)(modulationDepth * modulationIndex * sampleRate / juce::MathConstants<double>::twoPi); }
     void resetModState() noexcept
     {
-        modulationHP = 0.0f;
-        prevModulation = 0.0f;
+        state.modulationHP[0] = 0.0f;
+        state.prevModulation[0] = 0.0f;
+        state.lastOutput[0] = 0.0f;
     }
 
+    // reszta przyrostu ponizej kroku licznika dokladana raz na blok (po policzeniu operatorow),
+    // dzieki temu faza nie odplywa od czestotliwosci nawet na wielominutowych dzwiekach
+    void advancePhaseFraction(int numSamples) noexcept
+    {
+        const juce::uint64 sum = phaseFraction + (juce::uint64)incrementFraction * (juce::uint64)numSamples;
+        state.phase[0] += (juce::uint32)(sum >> 32);
+        phaseFraction = (juce::uint32)sum;
+    }
+
+    // stan dla wspolnego liczenia kilku glosow (OperatorKernel)
+    OperatorState<1>& getState() noexcept { return state; }
+    const OperatorState<1>& getState() const noexcept { return state; }
+
 private:
     void updatePhaseIncrement(float freq);
+    void updateDcBlocker();
+    void updateModulationScale();
 
     float noteBaseFrequency = 0.0f;
     float coarse = 1.0f;
     float fine = 0.0f;
-    float gain = 0.0f;
 
-    double sampleRate = 48000.0;
+    double sampleRate = 48000.0;    // czestotliwosc hosta, operator liczy z sampleRate * oversamplingFactor
+    int oversamplingFactor = 1;
     int waveType = 0;
+    bool bandLimited = false;
+    int precision = OperatorKernel::exactPrecision;
+    int modulationMode = OperatorKernel::frequencyModulation;
+
+    float modulationDepth = 0.05f;      // FM: przyrost fazy (rad) na jednostke modulacji przy czestotliwosci hosta
+    float modulationIndex = 1.0f;
+    float modulationScale = 0.05f;      // to co dostaje kernel, na probke operatora
+    float dcBlockerCoefficient = 1.0f;
 
-    float modulationScale = 0.05f; 
-    float currentPhase = 0.0f;
-    float phaseIncrement = 0.0f;
+    ParameterRamp gainRamp{ ParameterRamp::linear };
+    double gainRampSeconds = 0.0;
 
-    float modulationHP = 0.0f;  // stan filtra HPF
-    float prevModulation = 0.0f;  // poprzednia próbka modulacji
+    // faza, przyrost fazy, stan HPF modulacji i gain
+    OperatorState<1> state;
+    juce::uint32 incrementFraction = 0;    // nizsze 32 bity przyrostu (licznik 32.32)
+    juce::uint32 phaseFraction = 0;
 };
 
@@ -0,0 +1,208 @@
+/*
+  ==============================================================================
+
+    OversamplingData.cpp
+    Created: 17 Oct 2026 10:31:07pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "OversamplingData.h"
+
+const float OversamplingData::firstStageCoefficients[firstStageSize] =
+{
+    3.101133251e-01f, -8.368363972e-02f, 3.231388668e-02f, -1.128164681e-02f, 2.926126739e-03f, -3.880520153e-04f
+};
+
+const float OversamplingData::lastStageCoefficients[lastStageSize] =
+{
+    3.171598002e-01f, -1.026680393e-01f, 5.807684408e-02f, -3.794381218e-02f, 2.616121265e-02f, -1.836183182e-02f,
+    1.287160363e-02f, -8.900495062e-03f, 6.012201478e-03f, -3.931392557e-03f, 2.464012560e-03f, -1.461907488e-03f,
+    8.066824770e-04f, -4.023011307e-04f, 1.715742046e-04f, -5.415183392e-05f
+};
+
+void HalfBandDecimator::prepare(const float* newCoefficients, int newNumCoefficients, int maxOutputSamples)
+{
+    coefficients = newCoefficients;
+    numCoefficients = newNumCoefficients;
+    historyLength = 4 * numCoefficients - 2;
+    buffer.allocate((size_t)(historyLength + 2 * maxOutputSamples), true);
+}
+
+void HalfBandDecimator::reset() noexcept
+{
+    std::fill(buffer.get(), buffer.get() + historyLength, 0.0f);
+}
+
+void HalfBandDecimator::process(const float* input, float* output, int numOutputSamples) noexcept
+{
+    // x[t] = wejscie biezacego bloku, x[-1] .. x[-historyLength] = koniec poprzedniego
+    const int numInputSamples = 2 * numOutputSamples;
+    float* x = buffer.get() + historyLength;
+    std::copy(input, input + numInputSamples, x);
+
+    // probka i operatora lezy w chwili i + 1 (faza po przyroscie) - srodek na nieparzystej probce wejscia
+    // daje opoznienie rowno numCoefficients probek wyjscia, obok srodka pary symetrycznych wspolczynnikow
+    const int centre = 2 * numCoefficients - 1;
+
+    for (int m = 0; m < numOutputSamples; ++m)
+    {
+        const float* c = x + 2 * m - centre;
+        float sum = 0.5f * c[0];
+
+        for (int j = 0; j < numCoefficients; ++j)
+            sum += coefficients[j] * (c[2 * j + 1] + c[-2 * j - 1]);
+
+        output[m] = sum;
+    }
+
+    std::copy(buffer.get() + numInputSamples, buffer.get() + numInputSamples + historyLength, buffer.get());
+}
+
+void OversamplingData::prepareToPlay(int samplesPerBlock)
+{
+    maxOutputSamples = juce::jmax(1, samplesPerBlock);
+
+    firstStage.prepare(firstStageCoefficients, firstStageSize, 2 * maxOutputSamples);
+    lastStage.prepare(lastStageCoefficients, lastStageSize, maxOutputSamples);
+    stageBuffer.allocate((size_t)(2 * maxOutputSamples), true);
+    delayBuffer.allocate((size_t)(getLatency(maxFactor) + maxOutputSamples), true);
+
+    reset();
+}
+
+void OversamplingData::reset() noexcept
+{
+    firstStage.reset();
+    lastStage.reset();
+    std::fill(delayBuffer.get(), delayBuffer.get() + delayLength, 0.0f);
+}
+
+void OversamplingData::setFactor(int newFactor, int targetLatency)
+{
+    factor = newFactor >= 4 ? 4 : (newFactor >= 2 ? 2 : 1);
+    delayLength = juce::jlimit(0, getLatency(maxFactor), targetLatency - getLatency(factor));
+    reset();
+}
+
+void OversamplingData::process(const float* input, float* output, int numSamples) noexcept
+{
+    jassert(numSamples <= maxOutputSamples);
+
+    if (factor == 4)
+    {
+        firstStage.process(input, stageBuffer.get(), 2 * numSamples);
+        lastStage.process(stageBuffer.get(), output, numSamples);
+    }
+    else if (factor == 2)
+    {
+        lastStage.process(input, output, numSamples);
+    }
+    else if (input != output)
+    {
+        std::copy(input, input + numSamples, output);
+    }
+
+    // glos z mniejszym faktorem opozniony tak jak glosy 4x
+    if (delayLength > 0)
+    {
+        float* line = delayBuffer.get();
+        std::copy(output, output + numSamples, line + delayLength);
+        std::copy(line, line + numSamples, output);
+        std::copy(line + numSamples, line + numSamples + delayLength, line);
+    }
+}
+
+int OversamplingData::getLatency(int oversamplingFactor) noexcept
+{
+    // 2x -> 1x: lastStageSize probek hosta, 4x -> 2x: firstStageSize probek przy 2x (parzyste - polowa)
+    if (oversamplingFactor >= 4)
+        return lastStageSize + firstStageSize / 2;
+    if (oversamplingFactor >= 2)
+        return lastStageSize;
+    return 0;
+}
+
+int OversamplingData::getMaxFactor(int mode) noexcept
+{
+    switch (mode)
+    {
+    case mode1x: return 1;
+    case mode2x: return 2;
+    default:     return 4;
+    }
+}
+
+int OversamplingData::chooseFactor(int mode, float bandwidth, double sampleRate) noexcept
+{
+    if (mode != automaticMode)
+        return getMaxFactor(mode);
+
+    // skladowa ponad polowa czestotliwosci odbija sie do factor * fs - f, ma wyladowac nad pasmem slyszalnym
+    const double audibleLimit = juce::jmin(20000.0, 0.417 * sampleRate);
+
+    for (int candidate = 1; candidate < maxFactor; candidate *= 2)
+    {
+        if (candidate * sampleRate - bandwidth >= audibleLimit)
+            return candidate;
+    }
+
+    return maxFactor;
+}
+
+float OversamplingData::estimateBandwidth(const RoutingMatrix& matrix, const float* frequencies, const float* gains,
+    const float* deviations, bool phaseModulation) noexcept
+{
+    const int numOperators = matrix.numOperators;
+    float edge[RoutingMatrix::maxOperators] = {};
+
+    for (int op = 0; op < numOperators; ++op)
+        edge[op] = frequencies[op];
+
+    // kolejnosc operatorow dowolna - numOperators przejsc wystarcza na najdluzszy lancuch
+    for (int pass = 0; pass < numOperators; ++pass)
+    {
+        for (int op = 0; op < numOperators; ++op)
+        {
+            float depth = 0.0f;
+            float widest = 0.0f;
+
+            for (int source = 0; source < numOperators; ++source)
+            {
+                if (gains[source] <= 0.0f)
+                    continue;
+
+                const int bit = 1 << source;
+
+                // PM: przesuniecie fazy a * sin(2pi f t) to dewiacja a * f
+                const float weight = phaseModulation ? gains[source] * frequencies[source] : gains[source];
+
+                if ((matrix.modulators[op] & bit) != 0)
+                {
+                    depth += weight;
+                    widest = juce::jmax(widest, edge[source]);
+                }
+
+                // sprzezenie liczone jak modulator o wlasnej czestotliwosci (harmoniczne jak pila)
+                if ((matrix.feedback[op] & bit) != 0)
+                {
+                    depth += matrix.feedbackAmount * weight;
+                    widest = juce::jmax(widest, frequencies[source]);
+                }
+            }
+
+            edge[op] = depth > 0.0f ? frequencies[op] + depth * deviations[op] + widest : frequencies[op];
+        }
+    }
+
+    float bandwidth = 0.0f;
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        if ((matrix.carriers & (1 << op)) != 0 && gains[op] > 0.0f)
+            bandwidth = juce::jmax(bandwidth, edge[op]);
+    }
+
+    return bandwidth;
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    OversamplingData.h
+    Created: 17 Oct 2026 10:31:07pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "RoutingMatrix.h"
+
+// decymator 2:1 - polowkowy FIR w postaci polifazowej, co drugi wspolczynnik = 0, wiec liczona tylko polowa
+// opoznienie zawsze calkowite (numCoefficients probek wyjscia), zeby glosy z roznym faktorem mozna bylo wyrownac
+class HalfBandDecimator
+{
+public:
+    // coefficients: h[+-1], h[+-3], h[+-5] ... od srodka, srodek = 0.5
+    void prepare(const float* newCoefficients, int newNumCoefficients, int maxOutputSamples);
+    void reset() noexcept;
+
+    // numOutputSamples probek z 2 * numOutputSamples probek wejscia
+    void process(const float* input, float* output, int numOutputSamples) noexcept;
+
+    int getLatency() const noexcept { return numCoefficients; }
+
+private:
+    const float* coefficients = nullptr;
+    int numCoefficients = 0;
+    int historyLength = 0;              // 4 * numCoefficients - 2 ostatnich probek wejscia
+    juce::HeapBlock<float> buffer;      // historia + biezacy blok
+};
+
+// nadprobkowanie operatorow jednego glosu: operatory licza factor razy wiecej probek, tu decymacja do
+// czestotliwosci hosta i opoznienie wyrownujace do latencji calego trybu (glosy 1x i 2x czekaja na 4x)
+class OversamplingData
+{
+public:
+    enum Mode
+    {
+        automaticMode = 0,      // kazdy glos wybiera sam z szerokosci widma
+        mode1x,
+        mode2x,
+        mode4x,
+        numModes
+    };
+
+    static constexpr int maxFactor = 4;
+
+    void prepareToPlay(int samplesPerBlock);
+    void reset() noexcept;
+
+    // factor 1, 2 albo 4, targetLatency = getLatency(najwiekszy faktor trybu), czysci historie filtrow
+    void setFactor(int newFactor, int targetLatency);
+    int getFactor() const noexcept { return factor; }
+
+    // numSamples probek wyjscia z factor * numSamples probek wejscia, input moze byc == output przy 1x
+    void process(const float* input, float* output, int numSamples) noexcept;
+
+    // latencja w probkach hosta dla danego faktoru
+    static int getLatency(int oversamplingFactor) noexcept;
+    static int getMaxFactor(int mode) noexcept;
+
+    // najmniejszy faktor przy ktorym odbicia widma nie wpadaja w pasmo slyszalne
+    static int chooseFactor(int mode, float bandwidth, double sampleRate) noexcept;
+
+    // gorna granica widma glosu regula Carsona: nosna + dewiacja + granica widma modulatora
+    // dla kazdego operatora z matrix: gorna czestotliwosc wlasnego ksztaltu, gain i dewiacja na jednostke modulacji -
+    // FM: w Hz, PM (phaseModulation): indeks w radianach, dewiacja w Hz rosnie z czestotliwoscia modulatora
+    static float estimateBandwidth(const RoutingMatrix& matrix, const float* frequencies, const float* gains,
+        const float* deviations, bool phaseModulation = false) noexcept;
+
+private:
+    // 4x -> 2x: szerokie pasmo przejsciowe, wystarczy 6 wspolczynnikow; 2x -> 1x: 16 wspolczynnikow, ~79 dB
+    // (Kaiser beta = 8, pasmo do 0.417 fs hosta, tlumienie od 0.583 fs)
+    static constexpr int firstStageSize = 6;
+    static constexpr int lastStageSize = 16;
+    static const float firstStageCoefficients[firstStageSize];
+    static const float lastStageCoefficients[lastStageSize];
+
+    HalfBandDecimator firstStage, lastStage;    // 4x -> 2x, 2x -> 1x
+    juce::HeapBlock<float> stageBuffer;         // wyjscie pierwszego stopnia przy 4x
+
+    int factor = 1;
+    int maxOutputSamples = 0;
+
+    // dopelnienie do latencji trybu
+    int delayLength = 0;
+    juce::HeapBlock<float> delayBuffer;         // delayLength probek historii + biezacy blok
+};
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    ParameterRamp.h
+    Created: 17 Oct 2026 11:52:10pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// wygladzanie parametru calymi blokami: zamiast skoku raz na processBlock tablica wartosci probka po probce
+// (jak juce::SmoothedValue, ale bez getNextValue na kazda probke - rampa liniowa liczona wprost z indeksu)
+class ParameterRamp
+{
+public:
+    // linear - gain; multiplicative - czestotliwosci (rowne kroki w oktawach), wartosci > 0
+    enum Shape { linear, multiplicative };
+
+    explicit ParameterRamp(Shape newShape = linear, float initialValue = 0.0f) noexcept
+        : shape(newShape), current(initialValue), target(initialValue) {}
+
+    // dlugosc rampy w probkach podanej czestotliwosci, 0 = bez wygladzania
+    // trwajaca rampa konczy sie po staremu, nowa dlugosc od nastepnego setTargetValue
+    void setRampLength(double sampleRate, double rampSeconds) noexcept
+    {
+        rampLength = juce::jmax(0, juce::roundToInt(sampleRate * rampSeconds));
+    }
+
+    void setTargetValue(float newTarget) noexcept
+    {
+        if (newTarget == target)
+            return;
+
+        target = newTarget;
+
+        if (rampLength == 0 || (shape == multiplicative && (current <= 0.0f || target <= 0.0f)))
+        {
+            jassert(shape == linear || target > 0.0f);
+            skip();
+            return;
+        }
+
+        remaining = rampLength;
+        step = shape == linear ? (target - current) / (float)rampLength
+                               : (float)std::exp(std::log((double)target / current) / rampLength);
+    }
+
+    // od razu na docelowa wartosc (nowa nuta - brak skoku do wygladzenia)
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        current = target = newValue;
+        remaining = 0;
+    }
+
+    void skip() noexcept { setCurrentAndTargetValue(target); }
+
+    bool isSmoothing() const noexcept { return remaining > 0; }
+    float getCurrentValue() const noexcept { return current; }
+    float getTargetValue() const noexcept { return target; }
+
+    // numSamples kolejnych wartosci do dest, po koncu rampy stala wartosc docelowa
+    void fill(float* dest, int numSamples) noexcept { render<false>(dest, numSamples); }
+    // dest *= kolejne wartosci (gain na tablicy obwiedni)
+    void applyGain(float* dest, int numSamples) noexcept { render<true>(dest, numSamples); }
+
+private:
+    template <bool Multiply>
+    void render(float* dest, int numSamples) noexcept
+    {
+        const int rampSamples = juce::jmin(numSamples, remaining);
+
+        if (rampSamples > 0)
+        {
+            float last;
+
+            if (shape == linear)
+            {
+                // wprost z indeksu - bez zaleznosci miedzy probkami, kompilator wektoryzuje
+                for (int i = 0; i < rampSamples; ++i)
+                {
+                    const float value = current + step * (float)(i + 1);
+                    dest[i] = Multiply ? dest[i] * value : value;
+                }
+
+                last = current + step * (float)rampSamples;
+            }
+            else
+            {
+                // mnozenie co probke zamiast std::exp
+                last = current;
+                for (int i = 0; i < rampSamples; ++i)
+                {
+                    last *= step;
+                    dest[i] = Multiply ? dest[i] * last : last;
+                }
+            }
+
+            remaining -= rampSamples;
+            current = remaining > 0 ? last : target;
+        }
+
+        if constexpr (Multiply)
+        {
+            if (target != 1.0f)
+                juce::FloatVectorOperations::multiply(dest + rampSamples, target, numSamples - rampSamples);
+        }
+        else
+            juce::FloatVectorOperations::fill(dest + rampSamples, target, numSamples - rampSamples);
+    }
+
+    Shape shape;
+    float current, target;
+    float step = 0.0f;      // linear: przyrost na probke, multiplicative: mnoznik na probke
+    int rampLength = 0;
+    int remaining = 0;
+};
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    RoutingMatrix.h
+    Created: 17 Oct 2026 7:40:18pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+// polaczenia operatorow jako bity operatorow (1 = osc1, 2 = osc2, 4 = osc3, 8 = osc4 ...)
+struct RoutingMatrix
+{
+    static constexpr int maxOperators = 8;
+
+    int numOperators;
+    int modulators[maxOperators];   // kto moduluje osc1..osc8 w tej samej probce (bez petli)
+    int feedback[maxOperators];     // kto moduluje osc1..osc8 probka pozniej (sprzezenie, tez sam siebie)
+    int carriers;                   // co idzie na wyjscie
+    float feedbackAmount;           // wzmocnienie wszystkich sprzezen
+};
+
+namespace RoutingPresets
+{
+    constexpr int numAlgorithms = 8;
+
+    // algorytmy 1-8: cztery operatory, modulator ma zawsze wyzszy numer niz nosna
+    inline constexpr RoutingMatrix algorithms[numAlgorithms] =
+    {
+        { 4, { 2, 4, 8, 0 }, {}, 1, 0.0f },      // algorytm 1: osc4 -> osc3 -> osc2 -> osc1
+        { 4, { 2, 12, 0, 0 }, {}, 1, 0.0f },     // algorytm 2: (osc4 + osc3) -> osc2 -> osc1
+        { 4, { 6, 8, 8, 0 }, {}, 1, 0.0f },      // algorytm 3: osc4 -> (osc3 + osc2) -> osc1
+        { 4, { 4, 4, 8, 0 }, {}, 3, 0.0f },      // algorytm 4: osc4 -> osc3 -> (osc2 + osc1)
+        { 4, { 14, 0, 0, 0 }, {}, 1, 0.0f },     // algorytm 5: (osc4 + osc3 + osc2) -> osc1
+        { 4, { 8, 8, 8, 0 }, {}, 7, 0.0f },      // algorytm 6: osc4 -> (osc3 + osc2 + osc1)
+        { 4, { 12, 12, 0, 0 }, {}, 3, 0.0f },    // algorytm 7: (osc4 + osc3) -> (osc2 + osc1)
+        { 4, { 0, 0, 0, 0 }, {}, 15, 0.0f },     // algorytm 8: osc4 + osc3 + osc2 + osc1
+    };
+
+    // algorytm z osc4 modulujacym sam siebie (jak sprzezenie w DX7)
+    constexpr RoutingMatrix withFeedback(int algorithm, float amount)
+    {
+        RoutingMatrix matrix = algorithms[algorithm];
+        matrix.feedback[3] = 8;
+        matrix.feedbackAmount = amount;
+        return matrix;
+    }
+}
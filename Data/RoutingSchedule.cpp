@@ -0,0 +1,512 @@
+/*
+  ==============================================================================
+
+    RoutingSchedule.cpp
+    Created: 17 Oct 2026 7:52:31pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "RoutingSchedule.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace
+{
+    inline bool hasOperator(int mask, int op) noexcept
+    {
+        return ((mask >> op) & 1) != 0;
+    }
+
+    // nieznany ksztalt liczony jest jak sinus (jak w OperatorKernel)
+    inline int waveIndex(int waveType) noexcept
+    {
+        return juce::isPositiveAndBelow(waveType, FMAlgorithmRouter::numWaveTypes) ? waveType : 0;
+    }
+
+    inline int precisionIndex(int precision) noexcept
+    {
+        return juce::isPositiveAndBelow(precision, (int)OperatorKernel::numPrecisions) ? precision : 0;
+    }
+
+    inline int modeIndex(int mode) noexcept
+    {
+        return juce::isPositiveAndBelow(mode, (int)OperatorKernel::numModulationModes) ? mode : 0;
+    }
+
+    // indeks w tablicach wersji = (tryb * numPrecisions + dokladnosc) * numWaveTypes + ksztalt fali
+    template <typename Operators>
+    inline int variantIndex(const Operators& operators, int op) noexcept
+    {
+        return (modeIndex(operators.getModulationMode(op)) * OperatorKernel::numPrecisions
+                + precisionIndex(operators.getPrecision(op))) * FMAlgorithmRouter::numWaveTypes
+               + waveIndex(operators.getWaveType(op));
+    }
+
+    constexpr int numVariants = OperatorKernel::numModulationModes * OperatorKernel::numPrecisions * FMAlgorithmRouter::numWaveTypes;
+
+    template <typename Vec>
+    using TickFunction = Vec (*)(OperatorRegisters<Vec>&, Vec, Vec);
+
+    template <typename Vec, int... Index>
+    constexpr std::array<TickFunction<Vec>, sizeof...(Index)> makeTicks(std::integer_sequence<int, Index...>)
+    {
+        return { { &OperatorKernel::tick<Vec, Index % FMAlgorithmRouter::numWaveTypes,
+                                         (Index / FMAlgorithmRouter::numWaveTypes) % OperatorKernel::numPrecisions,
+                                         Index / (FMAlgorithmRouter::numWaveTypes * OperatorKernel::numPrecisions)>... } };
+    }
+}
+
+bool RoutingSchedule::compile(const RoutingMatrix& matrix)
+{
+    numSteps = 0;
+    numCarriers = 0;
+    directCarrier = -1;
+    feedbackSources = 0;
+    numOperators = juce::jlimit(0, maxOperators, matrix.numOperators);
+    feedbackAmount = matrix.feedbackAmount;
+
+    const int allOperators = (1 << numOperators) - 1;
+    int modulators[maxOperators] = {};
+    int feedback[maxOperators] = {};
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        modulators[op] = matrix.modulators[op] & allOperators;
+        feedback[op] = matrix.feedback[op] & allOperators;
+    }
+
+    // do ktorych operatorow dociera wyjscie danego operatora (bez i ze sprzezeniami)
+    int forwardReach[maxOperators] = {};
+    int reach[maxOperators] = {};
+    int usedAsSource = 0;
+
+    for (int op = 0; op < numOperators; ++op)
+    {
+        for (int source = 0; source < numOperators; ++source)
+        {
+            if (hasOperator(modulators[op], source))
+                forwardReach[source] |= 1 << op;
+            if (hasOperator(modulators[op] | feedback[op], source))
+                reach[source] |= 1 << op;
+        }
+
+        usedAsSource |= modulators[op] | feedback[op];
+    }
+
+    for (int k = 0; k < numOperators; ++k)
+    {
+        for (int op = 0; op < numOperators; ++op)
+        {
+            if (hasOperator(forwardReach[op], k))
+                forwardReach[op] |= forwardReach[k];
+            if (hasOperator(reach[op], k))
+                reach[op] |= reach[k];
+        }
+    }
+
+    for (int op = 0; op < numOperators; ++op)
+        if (hasOperator(forwardReach[op], op))
+            return false;
+
+    // petla sprzezenia = operatory osiagalne nawzajem
+    int loop[maxOperators] = {};
+    for (int op = 0; op < numOperators; ++op)
+    {
+        loop[op] = 1 << op;
+
+        for (int other = 0; other < numOperators; ++other)
+            if (hasOperator(reach[op], other) && hasOperator(reach[other], op))
+                loop[op] |= 1 << other;
+    }
+
+    // krok gotowy gdy wszystko spoza jego petli jest policzone, najwyzszy operator pierwszy (jak w presetach)
+    int done = 0;
+    int numOrdered = 0;
+
+    while (done != allOperators)
+    {
+        int next = -1;
+
+        for (int op = numOperators - 1; op >= 0 && next < 0; --op)
+        {
+            if (hasOperator(done, op))
+                continue;
+
+            int sources = 0;
+            for (int member = 0; member < numOperators; ++member)
+                if (hasOperator(loop[op], member))
+                    sources |= modulators[member] | feedback[member];
+
+            if ((sources & ~loop[op] & ~done) == 0)
+                next = op;
+        }
+
+        if (next < 0)
+        {
+            jassertfalse; // nie powinno sie zdarzyc - petle sa juz sklejone w jeden krok
+            numSteps = 0;
+            return false;
+        }
+
+        auto& step = steps[numSteps++];
+        step.first = numOrdered;
+        step.count = 0;
+
+        // w petli kolejnosc modulacji z tej samej probki
+        int remaining = loop[next];
+        while (remaining != 0)
+        {
+            for (int op = numOperators - 1; op >= 0; --op)
+            {
+                if (hasOperator(remaining, op) && (modulators[op] & remaining) == 0)
+                {
+                    order[numOrdered++] = op;
+                    remaining &= ~(1 << op);
+                    ++step.count;
+                    break;
+                }
+            }
+        }
+
+        step.perSample = step.count > 1 || hasOperator(feedback[next], next);
+        done |= loop[next];
+    }
+
+    // wejscia od najwyzszego operatora: (out4 + out3) + out2 ...
+    for (int op = 0; op < numOperators; ++op)
+    {
+        int count = 0;
+
+        for (int source = numOperators - 1; source >= 0; --source)
+            if (hasOperator(modulators[op], source))
+                inputs[op][count++] = { source, sameSample };
+
+        numModulators[op] = count;
+
+        // sprzezenie na siebie zawsze ostatnie
+        for (int source = numOperators - 1; source >= 0; --source)
+        {
+            if (source != op && hasOperator(feedback[op], source))
+            {
+                inputs[op][count++] = { source, delayed };
+                feedbackSources |= 1 << source;
+            }
+        }
+
+        if (hasOperator(feedback[op], op))
+        {
+            inputs[op][count++] = { op, delayed };
+            feedbackSources |= 1 << op;
+        }
+
+        numInputs[op] = count;
+    }
+
+    for (int op = numOperators - 1; op >= 0; --op)
+        if (hasOperator(matrix.carriers, op))
+            carriers[numCarriers++] = op;
+
+    if (numCarriers == 1 && !hasOperator(usedAsSource, carriers[0]))
+        directCarrier = carriers[0];
+
+    return true;
+}
+
+//==============================================================================
+template <typename Operators>
+void RoutingSchedule::process(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples) const
+{
+    constexpr int lanes = Operators::numLanes;
+    const int numValues = numSamples * lanes;
+
+    if (!isValid() || numOperators > Operators::numOperators)
+    {
+        jassertfalse; // nieskompilowany harmonogram albo za malo operatorow w glosie
+        std::fill(output, output + numValues, 0.0f);
+        return;
+    }
+
+    if (numSamples <= 0)
+        return;
+
+    for (int s = 0; s < numSteps; ++s)
+    {
+        if (steps[s].perSample)
+            processLoop(steps[s], operators, blocks, output, numSamples);
+        else
+            processBlockStep(steps[s], operators, blocks, output, numSamples);
+    }
+
+    // srednia nosnych
+    if (directCarrier < 0)
+    {
+        if (numCarriers == 0)
+        {
+            std::fill(output, output + numValues, 0.0f);
+        }
+        else
+        {
+            std::copy(blocks.out[carriers[0]], blocks.out[carriers[0]] + numValues, output);
+
+            for (int c = 1; c < numCarriers; ++c)
+            {
+                const float* carrier = blocks.out[carriers[c]];
+                for (int i = 0; i < numValues; ++i)
+                    output[i] += carrier[i];
+            }
+
+            if (numCarriers > 1)
+            {
+                const float count = (float)numCarriers;
+                const float scale = 1.0f / count;
+
+                for (int i = 0; i < numValues; ++i)
+                    output[i] = Operators::exact ? output[i] / count : output[i] * scale;
+            }
+        }
+    }
+
+    // ostatnia probka dla sprzezen w nastepnym bloku
+    for (int op = 0; op < numOperators; ++op)
+    {
+        if (hasOperator(feedbackSources, op))
+        {
+            const float* last = blocks.out[op] + numValues - lanes;
+            std::copy(last, last + lanes, operators.getState(op).lastOutput);
+        }
+    }
+}
+
+template <typename Operators>
+const float* RoutingSchedule::gatherModulation(int op, Operators& operators, const OperatorBlocks& blocks,
+    int numSamples) const
+{
+    constexpr int lanes = Operators::numLanes;
+    const int numValues = numSamples * lanes;
+    const Input* opInputs = inputs[op];
+    const int numExternal = numInputs[op] - (hasSelfFeedback(op) ? 1 : 0);
+
+    if (numExternal == 0)
+        return nullptr;
+
+    if (numExternal == 1 && numModulators[op] == 1)
+        return blocks.out[opInputs[0].source];
+
+    float* mod = blocks.modulation;
+
+    if (numModulators[op] > 0)
+        std::copy(blocks.out[opInputs[0].source], blocks.out[opInputs[0].source] + numValues, mod);
+    else
+        std::fill(mod, mod + numValues, 0.0f);
+
+    for (int j = 1; j < numModulators[op]; ++j)
+    {
+        const float* source = blocks.out[opInputs[j].source];
+        for (int i = 0; i < numValues; ++i)
+            mod[i] += source[i];
+    }
+
+    // sprzezenie od operatora z wczesniejszego kroku - jego blok jest juz policzony
+    for (int j = numModulators[op]; j < numExternal; ++j)
+    {
+        const float* source = blocks.out[opInputs[j].source];
+        const float* last = operators.getState(opInputs[j].source).lastOutput;
+
+        for (int i = 0; i < lanes; ++i)
+            mod[i] += feedbackAmount * last[i];
+        for (int i = lanes; i < numValues; ++i)
+            mod[i] += feedbackAmount * source[i - lanes];
+    }
+
+    return mod;
+}
+
+template <typename Operators>
+void RoutingSchedule::processBlockStep(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+    float* output, int numSamples) const
+{
+    const int op = order[step.first];
+
+    if (operators.isPruned(op))
+    {
+        skipOperator(op, operators, blocks, output, numSamples);
+        return;
+    }
+
+    operators.process(op, gatherModulation(op, operators, blocks, numSamples), blocks.env[op],
+        getDestination(op, blocks, output), numSamples);
+}
+
+template <typename Operators>
+void RoutingSchedule::processLoop(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+    float* output, int numSamples) const
+{
+    if (step.count > 1)
+    {
+        processLoopStep(step, operators, blocks, output, numSamples);
+        return;
+    }
+
+    // najczestszy przypadek - operator sam na siebie, ksztalt fali, dokladnosc i tryb wpisane na stale
+    static constexpr auto selfLoops = makeSelfLoops<Operators>(std::make_integer_sequence<int, numVariants>());
+
+    const int op = order[step.first];
+
+    if (operators.isPruned(op))
+    {
+        skipOperator(op, operators, blocks, output, numSamples);
+        return;
+    }
+
+    const auto function = selfLoops[(size_t)variantIndex(operators, op)];
+    (this->*function)(op, operators, blocks, output, numSamples);
+}
+
+template <typename Operators>
+void RoutingSchedule::skipOperator(int op, Operators& operators, const OperatorBlocks& blocks,
+    float* output, int numSamples) const
+{
+    // operator bez wkladu (findPrunedOperators) - faza dalej, sprzezenie od zera, zera dla odbiorcow
+    operators.skip(op, numSamples);
+
+    float* out = getDestination(op, blocks, output);
+    std::fill(out, out + numSamples * Operators::numLanes, 0.0f);
+}
+
+template <typename Operators, int WaveType, int Precision, int Mode>
+void RoutingSchedule::processSelfLoop(int op, Operators& operators, const OperatorBlocks& blocks,
+    float* output, int numSamples) const
+{
+    using Vec = OperatorKernel::VectorType<Operators::numLanes>;
+    constexpr int lanes = Operators::numLanes;
+
+    // wszystko spoza operatora policzone wczesniej calym blokiem, w petli zostaje tylko jego sprzezenie
+    const float* modulation = gatherModulation(op, operators, blocks, numSamples);
+    const float* env = blocks.env[op];
+    float* out = getDestination(op, blocks, output);
+    auto& state = operators.getState(op);
+
+    auto registers = OperatorKernel::loadRegisters<Vec>(state, operators.getDcBlockerCoefficient(op),
+        operators.getModulationScale(op));
+    const Vec amount = OperatorKernel::splat<Vec>(feedbackAmount);
+    Vec last = OperatorKernel::load<Vec>(state.lastOutput);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int offset = i * lanes;
+        const Vec self = amount * last;
+        const Vec m = (modulation != nullptr) ? OperatorKernel::load<Vec>(modulation + offset) + self : self;
+
+        last = OperatorKernel::tick<Vec, WaveType, Precision, Mode>(registers, m, OperatorKernel::load<Vec>(env + offset));
+        OperatorKernel::store(out + offset, last);
+    }
+
+    OperatorKernel::storeRegisters(registers, state);
+}
+
+template <typename Operators>
+void RoutingSchedule::processLoopStep(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+    float* output, int numSamples) const
+{
+    using Vec = OperatorKernel::VectorType<Operators::numLanes>;
+    constexpr int lanes = Operators::numLanes;
+
+    static constexpr auto ticks = makeTicks<Vec>(std::make_integer_sequence<int, numVariants>());
+
+    // skad brac wejscie w petli po probkach
+    enum LoopInputType { loopCurrent, loopPrevious, block, blockDelayed };
+    struct LoopInput
+    {
+        LoopInputType type;
+        int index;              // pozycja w petli
+        const float* data;      // blok operatora spoza petli
+        const float* last;      // jego ostatnia probka z poprzedniego bloku
+        bool isFeedback;
+    };
+
+    int position[maxOperators];
+    std::fill(position, position + maxOperators, -1);
+    for (int k = 0; k < step.count; ++k)
+        position[order[step.first + k]] = k;
+
+    OperatorRegisters<Vec> registers[maxOperators];
+    TickFunction<Vec> tick[maxOperators];
+    Vec current[maxOperators], previous[maxOperators];
+    LoopInput loopInputs[maxOperators][2 * maxOperators];
+    float* out[maxOperators];
+
+    for (int k = 0; k < step.count; ++k)
+    {
+        const int op = order[step.first + k];
+        auto& state = operators.getState(op);
+
+        registers[k] = OperatorKernel::loadRegisters<Vec>(state, operators.getDcBlockerCoefficient(op),
+            operators.getModulationScale(op));
+        tick[k] = ticks[(size_t)variantIndex(operators, op)];
+        current[k] = previous[k] = OperatorKernel::load<Vec>(state.lastOutput);
+        out[k] = getDestination(op, blocks, output);
+
+        for (int j = 0; j < numInputs[op]; ++j)
+        {
+            const auto& input = inputs[op][j];
+            const int source = position[input.source];
+            auto& loopInput = loopInputs[k][j];
+
+            loopInput.index = source;
+            loopInput.data = blocks.out[input.source];
+            loopInput.last = operators.getState(input.source).lastOutput;
+            loopInput.isFeedback = input.type == delayed;
+
+            // operator petli policzony wczesniej w tej probce ma juz nowa wartosc - poprzednia jest w previous
+            if (source >= 0)
+                loopInput.type = (input.type == delayed && source < k) ? loopPrevious : loopCurrent;
+            else
+                loopInput.type = input.type == delayed ? blockDelayed : block;
+        }
+    }
+
+    const Vec amount = OperatorKernel::splat<Vec>(feedbackAmount);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const int offset = i * lanes;
+
+        for (int k = 0; k < step.count; ++k)
+        {
+            const int op = order[step.first + k];
+            Vec modulation = OperatorKernel::splat<Vec>(0.0f);
+
+            for (int j = 0; j < numInputs[op]; ++j)
+            {
+                const auto& input = loopInputs[k][j];
+                Vec value;
+
+                switch (input.type)
+                {
+                case loopCurrent:  value = current[input.index]; break;
+                case loopPrevious: value = previous[input.index]; break;
+                case block:        value = OperatorKernel::load<Vec>(input.data + offset); break;
+                default:
+                    value = OperatorKernel::load<Vec>(i == 0 ? input.last : input.data + offset - lanes);
+                    break;
+                }
+
+                modulation = modulation + (input.isFeedback ? amount * value : value);
+            }
+
+            previous[k] = current[k];
+            current[k] = tick[k](registers[k], modulation, OperatorKernel::load<Vec>(blocks.env[op] + offset));
+            OperatorKernel::store(out[k] + offset, current[k]);
+        }
+    }
+
+    for (int k = 0; k < step.count; ++k)
+        OperatorKernel::storeRegisters(registers[k], operators.getState(order[step.first + k]));
+}
+
+template void RoutingSchedule::process<VoiceOperators>(VoiceOperators&, const OperatorBlocks&, float*, int) const;
+template void RoutingSchedule::process<LaneOperators>(LaneOperators&, const OperatorBlocks&, float*, int) const;
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    RoutingSchedule.h
+    Created: 17 Oct 2026 7:52:31pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "FMAlgorithmRouter.h"
+#include <array>
+#include <utility>
+
+// RoutingMatrix przeliczona raz (przy zmianie algorytmu) na plaska liste krokow w kolejnosci topologicznej
+// krok = jeden operator liczony calym blokiem albo petla sprzezenia liczona probka po probce
+class RoutingSchedule
+{
+public:
+    static constexpr int maxOperators = RoutingMatrix::maxOperators;
+
+    // false gdy modulacja w tej samej probce ma petle (petla musi isc przez feedback) - harmonogram zostaje pusty
+    bool compile(const RoutingMatrix& matrix);
+
+    bool isValid() const noexcept { return numSteps > 0; }
+    bool hasFeedback() const noexcept { return feedbackSources != 0; }
+    int getNumOperators() const noexcept { return numOperators; }
+
+    // zmiana wzmocnienia bez ponownej kompilacji
+    void setFeedbackAmount(float newAmount) noexcept { feedbackAmount = newAmount; }
+
+    // Operators = VoiceOperators albo LaneOperators, bufory jak w FMAlgorithmRouter
+    template <typename Operators>
+    void process(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples) const;
+
+private:
+    // skad operator bierze modulacje
+    enum InputType
+    {
+        sameSample,         // wyjscie wczesniejszego kroku albo operatora z tej samej petli, ta sama probka
+        delayed,            // sprzezenie: poprzednia probka
+    };
+
+    struct Input
+    {
+        int source;
+        InputType type;
+    };
+
+    struct Step
+    {
+        int first;          // operatory kroku: order[first] .. order[first + count - 1]
+        int count;
+        bool perSample;     // petla sprzezenia - wszystkie operatory kroku probka po probce
+    };
+
+    template <typename Operators>
+    void processBlockStep(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+        float* output, int numSamples) const;
+    template <typename Operators>
+    void processLoop(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+        float* output, int numSamples) const;
+    // pominiety operator pojedynczego kroku (petle kilku operatorow liczone zawsze w calosci)
+    template <typename Operators>
+    void skipOperator(int op, Operators& operators, const OperatorBlocks& blocks,
+        float* output, int numSamples) const;
+    template <typename Operators, int WaveType, int Precision, int Mode>
+    void processSelfLoop(int op, Operators& operators, const OperatorBlocks& blocks,
+        float* output, int numSamples) const;
+
+    template <typename Operators>
+    using SelfLoopFunction = void (RoutingSchedule::*)(int, Operators&, const OperatorBlocks&, float*, int) const;
+
+    // processSelfLoop dla kazdego ksztaltu fali, dokladnosci i trybu modulacji,
+    // indeks = (tryb * numPrecisions + dokladnosc) * numWaveTypes + ksztalt
+    template <typename Operators, int... Index>
+    static constexpr std::array<SelfLoopFunction<Operators>, sizeof...(Index)> makeSelfLoops(std::integer_sequence<int, Index...>)
+    {
+        return { { &RoutingSchedule::processSelfLoop<Operators, Index % FMAlgorithmRouter::numWaveTypes,
+                                                     (Index / FMAlgorithmRouter::numWaveTypes) % OperatorKernel::numPrecisions,
+                                                     Index / (FMAlgorithmRouter::numWaveTypes * OperatorKernel::numPrecisions)>... } };
+    }
+    template <typename Operators>
+    void processLoopStep(const Step& step, Operators& operators, const OperatorBlocks& blocks,
+        float* output, int numSamples) const;
+
+    // suma modulacji policzonej we wczesniejszych krokach (bez sprzezenia na siebie), nullptr = brak
+    template <typename Operators>
+    const float* gatherModulation(int op, Operators& operators, const OperatorBlocks& blocks, int numSamples) const;
+
+    bool hasSelfFeedback(int op) const noexcept
+    {
+        return numInputs[op] > numModulators[op] && inputs[op][numInputs[op] - 1].source == op;
+    }
+
+    // gdzie operator pisze wyjscie (jedyna nosna bez sprzezenia od razu na wyjscie)
+    float* getDestination(int op, const OperatorBlocks& blocks, float* output) const noexcept
+    {
+        return op == directCarrier ? output : blocks.out[op];
+    }
+
+    int numOperators = 0;
+    int numSteps = 0;
+    Step steps[maxOperators] = {};
+    int order[maxOperators] = {};
+
+    // wejscia operatorow: najpierw modulacja z tej samej probki od najwyzszego operatora, potem sprzezenia
+    // (sprzezenie na siebie ostatnie)
+    Input inputs[maxOperators][2 * maxOperators] = {};
+    int numModulators[maxOperators] = {};
+    int numInputs[maxOperators] = {};
+
+    int carriers[maxOperators] = {};
+    int numCarriers = 0;
+    int directCarrier = -1;
+    int feedbackSources = 0;        // bity operatorow ktorych ostatnia probka trzeba zapamietac
+    float feedbackAmount = 0.0f;
+};
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    ScopeBuffer.h
+    Created: 17 Oct 2026 11:59:30pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// probki wyjscia dla UI: jeden pisarz (watek audio, bez blokad i alokacji), czytelnicy (oscyloskop, analizator widma)
+// niczego nie zmieniaja, wiec moze ich byc kilku
+// czytelnik bierze ostatnie probki - jezeli pisarz w trakcie kopiowania nadpisal czytany fragment, ramka przepada
+class ScopeBuffer
+{
+public:
+    static constexpr int capacity = 8192;       // potega dwojki
+    static constexpr int maxReadSamples = capacity / 2;
+
+    void push(const float* samples, int numSamples) noexcept
+    {
+        auto position = written.load(std::memory_order_relaxed);
+
+        // blok dluzszy niz bufor - i tak zostaje tylko koncowka
+        if (numSamples > capacity)
+        {
+            position += (juce::uint64)(numSamples - capacity);
+            samples += numSamples - capacity;
+            numSamples = capacity;
+        }
+
+        // najpierw zapowiedz, potem probki - czytelnik po kopiowaniu wie, czy cos mu nadpisano
+        writing.store(position + (juce::uint64)numSamples, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < numSamples; ++i)
+            ring[(size_t)((position + (juce::uint64)i) & mask)].store(samples[i], std::memory_order_relaxed);
+
+        written.store(position + (juce::uint64)numSamples, std::memory_order_release);
+    }
+
+    // ostatnie numSamples probek do dest, false = jeszcze za malo probek albo pisarz je nadpisal
+    bool readLatest(float* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples <= maxReadSamples);
+
+        const auto end = written.load(std::memory_order_acquire);
+        if (end < (juce::uint64)numSamples)
+            return false;
+
+        const auto start = end - (juce::uint64)numSamples;
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = ring[(size_t)((start + (juce::uint64)i) & mask)].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return writing.load(std::memory_order_relaxed) - start <= (juce::uint64)capacity;
+    }
+
+    // ile probek zapisano od poczatku - czytelnik widzi, czy od ostatniego odczytu cos przyszlo
+    juce::uint64 getNumWritten() const noexcept { return written.load(std::memory_order_acquire); }
+
+private:
+    static constexpr juce::uint64 mask = capacity - 1;
+
+    std::array<std::atomic<float>, capacity> ring{};
+    std::atomic<juce::uint64> writing{ 0 }, written{ 0 };
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.cpp
+    Created: 17 Oct 2026 11:59:50pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser(const ScopeBuffer& sourceToUse)
+    : juce::Thread("FM spectrum analyser"), source(sourceToUse)
+{
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stopThread(1000);
+}
+
+void SpectrumAnalyser::run()
+{
+    // ~30 ramek na sekunde, tyle ile rysuje UI
+    const int frameIntervalMs = 33;
+
+    while (!threadShouldExit())
+    {
+        wait(frameIntervalMs);
+
+        // nic nowego (transport stoi) - bez FFT
+        const auto numWritten = source.getNumWritten();
+        if (numWritten == lastNumWritten)
+            continue;
+
+        // za malo probek albo nadpisane w trakcie kopiowania - ramka przepada
+        if (!source.readLatest(fftData.data(), fftSize))
+            continue;
+
+        lastNumWritten = numWritten;
+
+        const double rate = sampleRate.load();
+        if (rate != bandsSampleRate)
+            updateBands(rate);
+
+        computeFrame();
+        publishFrame();
+    }
+}
+
+void SpectrumAnalyser::updateBands(double rate)
+{
+    bandsSampleRate = rate;
+
+    // granice pasm rowno w skali logarytmicznej
+    const float top = juce::jmin(maxFrequency, (float)rate * 0.5f);
+    const float binWidth = (float)rate / (float)fftSize;
+
+    for (int band = 0; band <= numBands; ++band)
+    {
+        const float frequency = minFrequency * std::pow(top / minFrequency, (float)band / (float)numBands);
+        bandEdges[(size_t)band] = juce::jlimit(0.0f, (float)(fftSize / 2), frequency / binWidth);
+    }
+}
+
+void SpectrumAnalyser::computeFrame()
+{
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // sinus o amplitudzie 1 -> 0 dB (okno Hanna ma wzmocnienie 0.5)
+    const float normalisation = 4.0f / (float)fftSize;
+
+    // opadanie wolniej niz narastanie - widmo nie miga
+    const float release = 0.15f;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float low = bandEdges[(size_t)band];
+        const float high = bandEdges[(size_t)band + 1];
+        const int from = (int)std::ceil(low);
+        const int to = (int)std::floor(high);
+
+        float magnitude = 0.0f;
+        if (from <= to)
+        {
+            // pasmo obejmuje biny - najwiekszy
+            for (int bin = from; bin <= to; ++bin)
+                magnitude = juce::jmax(magnitude, fftData[(size_t)bin]);
+        }
+        else
+        {
+            // pasmo wezsze niz bin (niskie czestotliwosci) - interpolacja w srodku pasma
+            const float centre = 0.5f * (low + high);
+            const int bin = juce::jmin((int)centre, fftSize / 2 - 1);
+            const float fraction = centre - (float)bin;
+            magnitude = fftData[(size_t)bin] + (fftData[(size_t)bin + 1] - fftData[(size_t)bin]) * fraction;
+        }
+
+        const float decibels = juce::Decibels::gainToDecibels(magnitude * normalisation, minDecibels);
+        const float level = juce::jmap(decibels, minDecibels, 0.0f, 0.0f, 1.0f);
+
+        auto& current = smoothed[(size_t)band];
+        current = level > current ? level : current + (level - current) * release;
+    }
+}
+
+void SpectrumAnalyser::publishFrame() noexcept
+{
+    const int published = publishedFrame.load();
+    const int target = published == 0 ? 1 : 0;
+
+    // czytelnik kopiuje wlasnie te ramke - ta przepada, wygladzanie i tak zostaje w smoothed
+    if (readingFrame.load() == target)
+        return;
+
+    frames[(size_t)target] = smoothed;
+    publishedFrame.store(target);
+    frameCounter.fetch_add(1);
+}
+
+bool SpectrumAnalyser::readSpectrum(float* dest) noexcept
+{
+    const auto counter = frameCounter.load();
+    if (counter == lastReadCounter)
+        return false;
+
+    const int frame = publishedFrame.load();
+    if (frame < 0)
+        return false;
+
+    // zaznacz ramke, potem sprawdz czy dalej jest opublikowana - jezeli nie, pisarz mogl juz w niej pisac
+    readingFrame.store(frame);
+    const bool stillPublished = publishedFrame.load() == frame;
+
+    if (stillPublished)
+    {
+        std::copy(frames[(size_t)frame].begin(), frames[(size_t)frame].end(), dest);
+        lastReadCounter = counter;
+    }
+
+    readingFrame.store(-1);
+    return stillPublished;
+}
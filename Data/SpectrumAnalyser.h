@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 17 Oct 2026 11:59:50pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "ScopeBuffer.h"
+
+// widmo wyjscia liczone w osobnym watku o niskim priorytecie - watek audio tylko zapisuje probki do ScopeBuffer,
+// UI tylko kopiuje gotowe pasma. Gdy UI nie nadaza, ramki przepadaja - nikt na nikogo nie czeka
+class SpectrumAnalyser : public juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBands = 96;         // pasma logarytmiczne 20 Hz - 20 kHz
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDecibels = -90.0f;
+
+    explicit SpectrumAnalyser(const ScopeBuffer& source);
+    ~SpectrumAnalyser() override;
+
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+
+    // watek UI: numBands poziomow 0..1, false gdy od ostatniego odczytu nie ma nowej ramki
+    bool readSpectrum(float* dest) noexcept;
+
+    void run() override;
+
+private:
+    void updateBands(double rate);
+    void computeFrame();
+    void publishFrame() noexcept;
+
+    const ScopeBuffer& source;
+    std::atomic<double> sampleRate{ 44100.0 };
+
+    // tylko watek analizatora
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::array<float, 2 * fftSize> fftData{};
+    std::array<float, numBands> smoothed{};
+    std::array<float, numBands + 1> bandEdges{};    // granice pasm w binach FFT (ulamkowe)
+    double bandsSampleRate = 0.0;
+    juce::uint64 lastNumWritten = 0;
+
+    // podwojny bufor: pisarz pisze do ramki, ktorej nie ma opublikowanej, i pomija ja gdy czytelnik wlasnie ja kopiuje
+    std::array<std::array<float, numBands>, 2> frames{};
+    std::atomic<int> publishedFrame{ -1 };
+    std::atomic<int> readingFrame{ -1 };
+    std::atomic<juce::uint32> frameCounter{ 0 };
+    juce::uint32 lastReadCounter = 0;           // tylko watek UI
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
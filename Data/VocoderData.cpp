@@ -33,13 +33,9 @@ void VocoderData::prepareToPlay(double sampleRate, int samplesPerBlock)
         modFilters[band].coefficients = coeff;
         modFilters[band].reset();
 
-        carrierFiltersLeft[band].prepare(spec);
-        carrierFiltersLeft[band].coefficients = coeff;
-        carrierFiltersLeft[band].reset();
-
-        carrierFiltersRight[band].prepare(spec);
-        carrierFiltersRight[band].coefficients = coeff;
-        carrierFiltersRight[band].reset();
+        carrierFilters[band].prepare(spec);
+        carrierFilters[band].coefficients = coeff;
+        carrierFilters[band].reset();
     }
 }
 
@@ -74,21 +70,15 @@ void VocoderData::process(const juce::AudioBuffer<float>& modBuffer,
         float envelopeGain = smoothedEnv * 200.0f;
         bandEnvelopes[band] = envelopeGain;
 
-        // przetwarzamy carrier przez filtr i stosujemy obwiednie
-        const float* carrierLeft = carrierBuffer.getReadPointer(0);
-        float* outLeft = outputBuffer.getWritePointer(0);
-        const float* carrierRight = (carrierBuffer.getNumChannels() > 1) ? carrierBuffer.getReadPointer(1) : nullptr;
-        float* outRight = (outputBuffer.getNumChannels() > 1) ? outputBuffer.getWritePointer(1) : nullptr;
+        // przetwarzamy carrier przez filtr i stosujemy obwiednie (jeden bank - nosny jest mono)
+        const float* carrier = carrierBuffer.getReadPointer(0);
+        float* out = outputBuffer.getWritePointer(0);
 
         for (int i = 0; i < numSamples; ++i)
-        {
-            float processedCarrierL = carrierFiltersLeft[band].processSample(carrierLeft[i]);
-            outLeft[i] += processedCarrierL * envelopeGain;
-            if (outRight != nullptr && carrierRight != nullptr)
-            {
-                float processedCarrierR = carrierFiltersRight[band].processSample(carrierRight[i]);
-                outRight[i] += processedCarrierR * envelopeGain;
-            }
-        }
+            out[i] += carrierFilters[band].processSample(carrier[i]) * envelopeGain;
     }
+
+    // rozprowadzenie na pozostale kanaly dopiero na wyjsciu
+    for (int channel = 1; channel < outputBuffer.getNumChannels(); ++channel)
+        outputBuffer.copyFrom(channel, 0, outputBuffer, 0, 0, numSamples);
 }
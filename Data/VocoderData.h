@@ -15,6 +15,7 @@
 class VocoderData {
 public:
     void prepareToPlay(double sampleRate, int samplesPerBlock);
+    // carrierBuffer mono (kanal 0), wynik na wszystkie kanaly outputBuffer
     void process(const juce::AudioBuffer<float>& modBuffer,
         const juce::AudioBuffer<float>& carrierBuffer,
         juce::AudioBuffer<float>& outputBuffer);
@@ -24,8 +25,7 @@ public:
 private:
     static constexpr int numBands = 24;
     std::array<juce::dsp::IIR::Filter<float>, numBands> modFilters;        // filtry pasmowe dla modulatora
-    std::array<juce::dsp::IIR::Filter<float>, numBands> carrierFiltersLeft;  // filtry pasmowe dla noœnego (kanal L)
-    std::array<juce::dsp::IIR::Filter<float>, numBands> carrierFiltersRight; // filtry pasmowe dla noœnego (kanal R)
+    std::array<juce::dsp::IIR::Filter<float>, numBands> carrierFilters;      // filtry pasmowe dla nosnego (mono)
     std::array<float, numBands> bandEnvelopes{};  // obwiednie (gain) dla ka¿dego pasma
 
     // smoothing do wygladzania ¿eby nie by³o pop-ow
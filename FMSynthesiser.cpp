@@ -0,0 +1,504 @@
+/*
+  ==============================================================================
+
+    FMSynthesiser.cpp
+    Created: 17 Oct 2026 10:12:40am
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "FMSynthesiser.h"
+#include "Data/FMAlgorithmRouter.h"
+
+void VoiceList::pushBack(SynthVoice* voice) noexcept
+{
+    jassert(voice->prevInList == nullptr && voice->nextInList == nullptr);
+
+    voice->prevInList = tail;
+    if (tail != nullptr)
+        tail->nextInList = voice;
+    else
+        head = voice;
+
+    tail = voice;
+    ++numVoices;
+}
+
+void VoiceList::remove(SynthVoice* voice) noexcept
+{
+    if (voice->prevInList != nullptr)
+        voice->prevInList->nextInList = voice->nextInList;
+    else
+        head = voice->nextInList;
+
+    if (voice->nextInList != nullptr)
+        voice->nextInList->prevInList = voice->prevInList;
+    else
+        tail = voice->prevInList;
+
+    voice->prevInList = nullptr;
+    voice->nextInList = nullptr;
+    --numVoices;
+}
+
+void FMSynthesiser::prepareVoices(double sampleRate, int samplesPerBlock, int outputChannels)
+{
+    const juce::ScopedLock sl(lock);
+
+    setCurrentPlaybackSampleRate(sampleRate);
+
+    // wszystkie glosy tworzone raz, potem tylko przenoszone miedzy listami
+    while (getNumVoices() < maxVoices)
+        addVoice(new SynthVoice());
+
+    while (!activeVoices.isEmpty())
+        activeVoices.remove(activeVoices.front());
+    while (!freeVoices.isEmpty())
+        freeVoices.remove(freeVoices.front());
+
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto* voice = static_cast<SynthVoice*>(getVoice(i));
+        voice->prepareToPlay(sampleRate, samplesPerBlock, outputChannels);
+        voice->resetVoice();
+        voice->onNoteBegin = &onVoiceStart;
+        freeVoices.pushBack(voice);
+    }
+
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+    sharedFilter.prepareToPlay(sampleRate, samplesPerBlock, outputChannels);
+    lastStartedVoice = nullptr;
+
+    workersEnabled = true;
+    prepareWorkers();
+}
+
+void FMSynthesiser::prepareWorkers()
+{
+    // tylu pomocnikow ile pozwala limit - kilka instancji nie zajmuje wszystkich rdzeni kazda
+    workerPool.prepare(renderThreadLimit - 1, getSampleRate(), maxBlockSize);
+
+    // najwiecej zajmuje grupa: kanaly [probka][glos] i tablice etapow wszystkich jej glosow
+    const auto laneSamples = (size_t)(maxBlockSize * OversamplingData::maxFactor * LaneOperators::numLanes);
+    const auto scratchSize = (size_t)numLaneChannels * ScratchArena::getAllocationSize(laneSamples)
+        + (size_t)LaneOperators::numLanes * SynthVoice::getScratchSize(maxBlockSize);
+
+    for (int i = 0; i <= workerPool.getNumWorkers(); ++i)
+        if (renderScratch[(size_t)i].arena.getCapacity() != ScratchArena::getAllocationSize(scratchSize))
+            renderScratch[(size_t)i].arena.prepare(scratchSize);
+}
+
+void FMSynthesiser::releaseWorkers()
+{
+    const juce::ScopedLock sl(lock);
+    workersEnabled = false;
+    workerPool.release();
+}
+
+void FMSynthesiser::setRenderThreadLimit(int newLimit)
+{
+    newLimit = juce::jlimit(1, VoiceWorkerPool::maxWorkers + 1, newLimit);
+
+    // zapis tylko z tego watku (pod lockiem), wiec porownanie bez locka - bez zmiany nie blokujemy watku audio
+    if (newLimit == renderThreadLimit)
+        return;
+
+    // blokuje renderNextBlock na czas tworzenia/zatrzymania watkow - tylko przy zmianie limitu
+    const juce::ScopedLock sl(lock);
+    renderThreadLimit = newLimit;
+
+    if (workersEnabled)
+        prepareWorkers();
+}
+
+void FMSynthesiser::setVoiceLimit(int newLimit) noexcept
+{
+    voiceLimit = juce::jlimit(minVoices, maxVoices, newLimit);
+}
+
+int FMSynthesiser::takeRecomputeCount() noexcept
+{
+    // wolne glosy tez - parametry dostaja przy starcie nuty
+    int count = 0;
+    for (int i = 0; i < getNumVoices(); ++i)
+        count += static_cast<SynthVoice*>(getVoice(i))->takeRecomputeCount();
+    return count;
+}
+
+void FMSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* sound : sounds)
+    {
+        if (!sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel))
+            continue;
+
+        // ta sama nuta jeszcze brzmi (np. pedal) - zatrzymaj ja najpierw
+        for (auto* voice = activeVoices.front(); voice != nullptr; voice = voice->nextInList)
+        {
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+                stopVoice(voice, 1.0f, true);
+        }
+
+        auto* voice = static_cast<SynthVoice*>(findFreeVoice(sound, midiChannel, midiNoteNumber, isNoteStealingEnabled()));
+        if (voice == nullptr)
+            continue;
+
+        startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+        lastStartedVoice = voice;
+
+        if (!voice->isInActiveList)
+        {
+            freeVoices.remove(voice);
+            activeVoices.pushBack(voice);
+            voice->isInActiveList = true;
+        }
+    }
+}
+
+void FMSynthesiser::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* voice = activeVoices.front(); voice != nullptr; voice = voice->nextInList)
+    {
+        if (voice->getCurrentlyPlayingNote() != midiNoteNumber || !voice->isPlayingChannel(midiChannel))
+            continue;
+
+        if (auto* sound = voice->getCurrentlyPlayingSound())
+        {
+            if (sound->appliesToNote(midiNoteNumber) && sound->appliesToChannel(midiChannel))
+            {
+                voice->setKeyDown(false);
+
+                if (!(voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
+                    stopVoice(voice, velocity, allowTailOff);
+            }
+        }
+    }
+}
+
+void FMSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    const int numThreads = juce::jmin(renderThreadLimit, workerPool.getNumWorkers() + 1);
+
+    while (numSamples > 0)
+    {
+        const int blockSize = juce::jmin(numSamples, maxBlockSize);
+        const int numTasks = buildRenderTasks();
+
+        taskStartSample = startSample;
+        taskNumSamples = blockSize;
+
+        if (numThreads > 1 && numTasks > 1 && activeVoices.size() >= minVoicesForThreads)
+        {
+            // kazdy glos do swojego bufora, zadania rozdzielone miedzy watki
+            taskOutput = nullptr;
+            workerPool.run(numTasks, numThreads - 1, [](void* context, int taskIndex, int threadIndex)
+            {
+                static_cast<FMSynthesiser*>(context)->renderTask(taskIndex, threadIndex);
+            }, this);
+
+            // sumowanie zawsze w tej samej kolejnosci - wynik nie zalezy od watkow
+            for (int t = 0; t < numTasks; ++t)
+            {
+                const auto& task = renderTasks[(size_t)t];
+
+                for (int v = 0; v < task.numVoices; ++v)
+                {
+                    const auto& mix = task.voices[v]->mixBuffer;
+
+                    for (int channel = 0; channel < outputAudio.getNumChannels(); ++channel)
+                        outputAudio.addFrom(channel, startSample, mix, 0, 0, blockSize);
+                }
+            }
+        }
+        else
+        {
+            taskOutput = &outputAudio;
+
+            for (int t = 0; t < numTasks; ++t)
+                renderTask(t, 0);
+        }
+
+        renderSharedFilter(outputAudio, startSample, blockSize);
+
+        startSample += blockSize;
+        numSamples -= blockSize;
+    }
+
+    for (auto* voice = activeVoices.front(); voice != nullptr;)
+    {
+        auto* next = voice->nextInList;
+
+        // glos skonczyl (lacznie z wygaszaniem) - wraca do puli
+        if (voice->isFinished())
+        {
+            activeVoices.remove(voice);
+            freeVoices.pushBack(voice);
+            voice->isInActiveList = false;
+        }
+
+        voice = next;
+    }
+}
+
+int FMSynthesiser::buildRenderTasks()
+{
+    // glosy w trakcie wygaszania/czekajace na nute ida osobno, reszta do grup
+    int numScalar = 0;
+    int numPacked = 0;
+    int numTasks = 0;
+
+    for (auto* voice = activeVoices.front(); voice != nullptr; voice = voice->nextInList)
+    {
+        if (voicePacking && voice->canRenderPacked())
+            packedVoices[(size_t)numPacked++] = voice;
+        else
+            scalarVoices[(size_t)numScalar++] = voice;
+    }
+
+    for (int i = 0; i < numScalar; ++i)
+        renderTasks[(size_t)numTasks++] = { scalarVoices.data() + i, 1, false };
+
+    // sortowanie po kluczu - zwykle wszystkie glosy maja ten sam wiec prawie O(n)
+    for (int i = 1; i < numPacked; ++i)
+    {
+        auto* voice = packedVoices[(size_t)i];
+        const int key = voice->getRoutingKey();
+        int j = i;
+
+        while (j > 0 && packedVoices[(size_t)j - 1]->getRoutingKey() > key)
+        {
+            packedVoices[(size_t)j] = packedVoices[(size_t)j - 1];
+            --j;
+        }
+
+        packedVoices[(size_t)j] = voice;
+    }
+
+    for (int groupStart = 0; groupStart < numPacked;)
+    {
+        const int key = packedVoices[(size_t)groupStart]->getRoutingKey();
+        int groupEnd = groupStart + 1;
+
+        while (groupEnd < numPacked && groupEnd - groupStart < LaneOperators::numLanes
+               && packedVoices[(size_t)groupEnd]->getRoutingKey() == key)
+            ++groupEnd;
+
+        // pojedynczy glos nie oplaca sie pakowac
+        const int groupSize = groupEnd - groupStart;
+        renderTasks[(size_t)numTasks++] = { packedVoices.data() + groupStart, groupSize, groupSize > 1 };
+
+        groupStart = groupEnd;
+    }
+
+    return numTasks;
+}
+
+void FMSynthesiser::renderTask(int taskIndex, int threadIndex)
+{
+    const auto& task = renderTasks[(size_t)taskIndex];
+    auto& scratch = renderScratch[(size_t)threadIndex];
+
+    if (task.packed)
+    {
+        renderPackedGroup(task.voices, task.numVoices, scratch);
+        return;
+    }
+
+    auto* voice = task.voices[0];
+    voice->scratch = &scratch.arena;
+
+    if (taskOutput != nullptr)
+    {
+        voice->renderNextBlock(*taskOutput, taskStartSample, taskNumSamples);
+    }
+    else
+    {
+        voice->mixBuffer.clear(0, taskNumSamples);
+        voice->renderNextBlock(voice->mixBuffer, 0, taskNumSamples);
+    }
+}
+
+void FMSynthesiser::renderVoiceOutput(SynthVoice& voice)
+{
+    if (taskOutput != nullptr)
+    {
+        voice.renderOutput(*taskOutput, taskStartSample, taskNumSamples);
+    }
+    else
+    {
+        voice.mixBuffer.clear(0, taskNumSamples);
+        voice.renderOutput(voice.mixBuffer, 0, taskNumSamples);
+    }
+}
+
+void FMSynthesiser::renderSharedFilter(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    // obwiednia filtra z ostatnio zagranego glosu, gdy ten juz skonczyl - z najglosniejszego z grajacych
+    SynthVoice* source = (lastStartedVoice != nullptr && lastStartedVoice->isInActiveList) ? lastStartedVoice : nullptr;
+
+    if (source == nullptr)
+    {
+        for (auto* voice = activeVoices.front(); voice != nullptr; voice = voice->nextInList)
+            if (source == nullptr || voice->getEnvelopeLevel() > source->getEnvelopeLevel())
+                source = voice;
+    }
+
+    if (source == nullptr || !source->isFilterShared())
+    {
+        // cisza albo filtr w glosach - nastepna nuta zaczyna z czystym stanem
+        sharedFilter.reset();
+        return;
+    }
+
+    source->processSharedFilter(sharedFilter,
+        juce::dsp::AudioBlock<float>(outputAudio).getSubBlock((size_t)startSample, (size_t)numSamples));
+}
+
+void FMSynthesiser::renderPackedGroup(SynthVoice* const* voices, int numVoicesInGroup, RenderScratch& scratch)
+{
+    constexpr int lanes = LaneOperators::numLanes;
+    const int numSamples = taskNumSamples;
+
+    // wszystkie glosy grupy maja ten sam faktor (klucz), operatory licza operatorSamples
+    const int operatorSamples = numSamples * voices[0]->getOversamplingFactor();
+
+    jassert(numVoicesInGroup <= lanes && numSamples <= maxBlockSize);
+
+    // kanaly grupy i tablice etapow glosow tylko do konca grupy
+    ScratchArena::ScopedRewind rewind(scratch.arena);
+
+    bool allocated = true;
+
+    for (auto& channel : scratch.laneChannels)
+    {
+        channel = scratch.arena.allocate((size_t)(operatorSamples * lanes));
+        allocated = allocated && channel != nullptr;
+    }
+
+    for (int lane = 0; lane < numVoicesInGroup; ++lane)
+        allocated = voices[lane]->attachScratch(scratch.arena, numSamples) && allocated;
+
+    // arena za mala (nie powinno sie zdarzyc) - grupa cicho w tym bloku
+    if (!allocated)
+    {
+        if (taskOutput == nullptr)
+            for (int lane = 0; lane < numVoicesInGroup; ++lane)
+                voices[lane]->mixBuffer.clear(0, numSamples);
+        return;
+    }
+
+    // obwiednie najpierw - rampa gainu ustawia gain operatora na ten blok
+    for (int lane = 0; lane < numVoicesInGroup; ++lane)
+        voices[lane]->renderEnvelopes(numSamples);
+
+    // stan operatorow do tablic [glos], puste miejsca maja gain 0
+    LaneOperators operators;
+    for (int op = 0; op < 4; ++op)
+    {
+        const auto& osc = voices[0]->getOscillator(op + 1);
+        operators.waveType[op] = osc.getKernelWave();
+        operators.precision[op] = osc.getPrecision();
+        operators.modulationMode[op] = osc.getModulationMode();
+        operators.modulationScale[op] = osc.getModulationScale();
+        operators.dcBlockerCoefficient = osc.getDcBlockerCoefficient();
+
+        for (int lane = 0; lane < numVoicesInGroup; ++lane)
+            OperatorKernel::loadLane(operators.state[op], lane, voices[lane]->getOscillator(op + 1).getState());
+    }
+
+    // obwiednie przeplecione [probka][glos]
+    for (int op = 0; op < 4; ++op)
+    {
+        float* env = scratch.laneChannels[(size_t)laneEnvChannel + op];
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            if (lane < numVoicesInGroup)
+            {
+                const float* voiceEnv = voices[lane]->getEnvelopeBlock(op);
+                for (int sample = 0; sample < operatorSamples; ++sample)
+                    env[sample * lanes + lane] = voiceEnv[sample];
+            }
+            else
+            {
+                for (int sample = 0; sample < operatorSamples; ++sample)
+                    env[sample * lanes + lane] = 0.0f;
+            }
+        }
+    }
+
+    OperatorBlocks blocks;
+    for (int op = 0; op < 4; ++op)
+    {
+        blocks.env[op] = scratch.laneChannels[(size_t)laneEnvChannel + op];
+        blocks.out[op] = scratch.laneChannels[(size_t)laneOutChannel + op];
+    }
+    blocks.modulation = scratch.laneChannels[(size_t)laneModulationChannel];
+
+    float* groupOut = scratch.laneChannels[(size_t)laneOutputChannel];
+    voices[0]->processRouting(operators, blocks, groupOut, operatorSamples);
+
+    // z powrotem do glosow - filtr, gain i miks jak zawsze
+    for (int lane = 0; lane < numVoicesInGroup; ++lane)
+    {
+        auto* voice = voices[lane];
+        float* voiceOut = voice->getOperatorOutputBlock();
+
+        for (int sample = 0; sample < operatorSamples; ++sample)
+            voiceOut[sample] = groupOut[sample * lanes + lane];
+
+        for (int op = 0; op < 4; ++op)
+        {
+            auto& osc = voice->getOscillator(op + 1);
+            OperatorKernel::storeLane(operators.state[op], lane, osc.getState());
+            osc.advancePhaseFraction(operatorSamples);
+        }
+
+        voice->decimateOutput(numSamples);
+
+        renderVoiceOutput(*voice);
+        voice->updateNoteState();
+    }
+}
+
+juce::SynthesiserVoice* FMSynthesiser::findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+    int midiNoteNumber, bool stealIfNoneAvailable) const
+{
+    if (activeVoices.size() < voiceLimit && !freeVoices.isEmpty())
+        return freeVoices.front();
+
+    if (stealIfNoneAvailable)
+        return findVoiceToSteal(soundToPlay, midiChannel, midiNoteNumber);
+
+    return nullptr;
+}
+
+juce::SynthesiserVoice* FMSynthesiser::findVoiceToSteal(juce::SynthesiserSound*, int, int) const
+{
+    // najcichszy glos wg obwiedni, glosy juz wygaszane i puszczone klawisze maja pierwszenstwo
+    SynthVoice* quietest = nullptr;
+    float quietestLevel = 0.0f;
+
+    for (auto* voice = activeVoices.front(); voice != nullptr; voice = voice->nextInList)
+    {
+        float level = voice->getEnvelopeLevel();
+
+        if (voice->isStealFadeActive())
+            level -= 2.0f;
+        else if (!voice->isKeyDown())
+            level -= 1.0f;
+
+        if (quietest == nullptr || level < quietestLevel)
+        {
+            quietest = voice;
+            quietestLevel = level;
+        }
+    }
+
+    return quietest;
+}
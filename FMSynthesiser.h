@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    FMSynthesiser.h
+    Created: 17 Oct 2026 10:12:40am
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <array>
+#include "SynthVoice.h"
+#include "VoiceWorkerPool.h"
+
+// lista glosow oparta na wskaznikach w samych glosach - bez alokacji, O(1)
+class VoiceList
+{
+public:
+    SynthVoice* front() const noexcept { return head; }
+    int size() const noexcept { return numVoices; }
+    bool isEmpty() const noexcept { return head == nullptr; }
+
+    void pushBack(SynthVoice* voice) noexcept;
+    void remove(SynthVoice* voice) noexcept;
+
+private:
+    SynthVoice* head = nullptr;
+    SynthVoice* tail = nullptr;
+    int numVoices = 0;
+};
+
+class FMSynthesiser : public juce::Synthesiser
+{
+public:
+    static constexpr int minVoices = 16;
+    static constexpr int maxVoices = 128;
+
+    // ponizej tylu aktywnych glosow watki pomocnicze sie nie oplacaja
+    static constexpr int minVoicesForThreads = 8;
+
+    // tworzy pule glosow i watki pomocnicze (tylko tutaj, nigdy w watku audio)
+    void prepareVoices(double sampleRate, int samplesPerBlock, int outputChannels);
+    void releaseWorkers();
+
+    // ile glosow moze grac naraz, reszta jest kradziona
+    void setVoiceLimit(int newLimit) noexcept;
+    int getVoiceLimit() const noexcept { return voiceLimit; }
+
+    int getNumActiveVoices() const noexcept { return activeVoices.size(); }
+    SynthVoice* getFirstActiveVoice() const noexcept { return activeVoices.front(); }
+
+    // glosy z tym samym algorytmem liczone razem po numLanes (SIMD)
+    void setVoicePacking(bool shouldPack) noexcept { voicePacking = shouldPack; }
+    bool isVoicePackingEnabled() const noexcept { return voicePacking; }
+
+    // ile watkow (lacznie z watkiem audio) liczy glosy, 1 = bez pomocnikow
+    // tworzy/usuwa pomocnikow - tylko poza watkiem audio (parametr THREADS zmieniany w watku wiadomosci)
+    void setRenderThreadLimit(int newLimit);
+    int getRenderThreadLimit() const noexcept { return renderThreadLimit; }
+
+    // wolane tuz przed startem nuty, zeby glos mial aktualne parametry (kradziony glos - dopiero po wygaszeniu)
+    std::function<void(SynthVoice&)> onVoiceStart;
+
+    // suma przeliczen wspolczynnikow wszystkich glosow od ostatniego wywolania (watek audio, po renderNextBlock)
+    int takeRecomputeCount() noexcept;
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    juce::SynthesiserVoice* findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+        int midiNoteNumber, bool stealIfNoneAvailable) const override;
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int midiChannel,
+        int midiNoteNumber) const override;
+
+private:
+    struct RenderScratch;
+
+    // jedno zadanie: pojedynczy glos albo grupa liczona razem
+    struct RenderTask
+    {
+        SynthVoice* const* voices;
+        int numVoices;
+        bool packed;
+    };
+
+    void prepareWorkers();
+    int buildRenderTasks();
+    void renderTask(int taskIndex, int threadIndex);
+    void renderPackedGroup(SynthVoice* const* voices, int numVoicesInGroup, RenderScratch& scratch);
+    void renderVoiceOutput(SynthVoice& voice);
+    void renderSharedFilter(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+
+    VoiceList freeVoices, activeVoices;
+    int voiceLimit = 64;
+
+    bool voicePacking = true;
+    int maxBlockSize = 0;
+    std::array<SynthVoice*, maxVoices> scalarVoices{};
+    std::array<SynthVoice*, maxVoices> packedVoices{};
+    std::array<RenderTask, maxVoices> renderTasks{};
+
+    // cel biezacego bloku, nullptr = kazdy glos do swojego bufora (watki)
+    juce::AudioBuffer<float>* taskOutput = nullptr;
+    int taskStartSample = 0;
+    int taskNumSamples = 0;
+
+    VoiceWorkerPool workerPool;
+    int renderThreadLimit = 1;
+    bool workersEnabled = false;        // miedzy prepareVoices a releaseWorkers
+
+    // filtr parafoniczny na sumie glosow, sterowany obwiednia ostatnio zagranego glosu
+    FilterData sharedFilter;
+    SynthVoice* lastStartedVoice = nullptr;
+
+    // obwiednie, wyjscia operatorow, modulacja i wyjscie grupy ulozone [probka][glos]
+    enum LaneChannel
+    {
+        laneEnvChannel = 0, laneOutChannel = 4, laneModulationChannel = 8, laneOutputChannel,
+        numLaneChannels
+    };
+
+    // pamiec robocza watku: tablice etapow liczonych glosow i kanaly grupy, cofana po kazdym zadaniu
+    struct RenderScratch
+    {
+        ScratchArena arena;
+        std::array<float*, numLaneChannels> laneChannels{};
+    };
+
+    // osobna dla kazdego watku
+    std::array<RenderScratch, VoiceWorkerPool::maxWorkers + 1> renderScratch;
+};
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    ParameterRegistry.cpp
+    Created: 17 Oct 2026 11:04:52pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "ParameterRegistry.h"
+
+namespace
+{
+    const std::atomic<float>* resolve(juce::AudioProcessorValueTreeState& apvts, const juce::String& id)
+    {
+        auto* value = apvts.getRawParameterValue(id);
+        jassert(value != nullptr); // brak parametru w createParameters
+        return value;
+    }
+
+    inline float read(const std::atomic<float>* value) noexcept
+    {
+        return value->load(std::memory_order_relaxed);
+    }
+
+    inline int readChoice(const std::atomic<float>* value) noexcept
+    {
+        return static_cast<int> (read(value));
+    }
+
+    inline bool operator!= (const OscillatorPatch& a, const OscillatorPatch& b) noexcept
+    {
+        return a.waveType != b.waveType || a.coarse != b.coarse || a.fine != b.fine
+            || a.gain != b.gain || a.modulationIndex != b.modulationIndex;
+    }
+
+    inline bool operator!= (const EnvelopePatch& a, const EnvelopePatch& b) noexcept
+    {
+        return a.attack != b.attack || a.decay != b.decay || a.sustain != b.sustain || a.release != b.release
+            || a.curve != b.curve;
+    }
+}
+
+ParameterRegistry::ParameterRegistry(juce::AudioProcessorValueTreeState& apvts)
+{
+    for (int op = 0; op < 4; ++op)
+    {
+        const juce::String prefix = "OSC" + juce::String(op + 1);
+        auto& handles = operators[op];
+
+        handles.waveType = resolve(apvts, prefix + "WAVETYPE");
+        handles.coarse = resolve(apvts, prefix + "COARSE");
+        handles.fine = resolve(apvts, prefix + "FINE");
+        handles.gain = resolve(apvts, prefix + "GAIN");
+        handles.modulationIndex = resolve(apvts, prefix + "INDEX");
+        handles.attack = resolve(apvts, prefix + "ATTACK");
+        handles.decay = resolve(apvts, prefix + "DECAY");
+        handles.sustain = resolve(apvts, prefix + "SUSTAIN");
+        handles.release = resolve(apvts, prefix + "RELEASE");
+    }
+
+    algorithm = resolve(apvts, "ALGORITHM");
+    feedback = resolve(apvts, "FEEDBACK");
+    oversampling = resolve(apvts, "OVERSAMPLING");
+    precision = resolve(apvts, "PRECISION");
+    waveQuality = resolve(apvts, "WAVEQUALITY");
+    modulationMode = resolve(apvts, "MODMODE");
+    rampTime = resolve(apvts, "RAMPTIME");
+    silenceThreshold = resolve(apvts, "SILENCE");
+
+    filterType = resolve(apvts, "FILTERTYPE");
+    filterCutoff = resolve(apvts, "FILTERFREQ");
+    filterResonance = resolve(apvts, "FILTERRES");
+    filterEnabled = resolve(apvts, "FILTERON");
+    filterParaphonic = resolve(apvts, "FILTERPARA");
+    modAttack = resolve(apvts, "MODATTACK");
+    modDecay = resolve(apvts, "MODDECAY");
+    modSustain = resolve(apvts, "MODSUSTAIN");
+    modRelease = resolve(apvts, "MODRELEASE");
+    envelopeCurve = resolve(apvts, "ENVCURVE");
+
+    vocoderEnabled = resolve(apvts, "VOCODER");
+    smoothingFactor = resolve(apvts, "SMOOTHFAC");
+
+    voiceLimit = resolve(apvts, "VOICES");
+}
+
+void ParameterRegistry::makeSnapshot(PatchSnapshot& snapshot) const noexcept
+{
+    PatchSnapshot next = snapshot;
+    const int curve = readChoice(envelopeCurve);
+
+    for (int op = 0; op < 4; ++op)
+    {
+        const auto& handles = operators[op];
+        auto& oscillator = next.oscillators[op];
+        auto& envelope = next.envelopes[op];
+
+        oscillator.waveType = readChoice(handles.waveType);
+        oscillator.coarse = read(handles.coarse);
+        oscillator.fine = read(handles.fine);
+        oscillator.gain = read(handles.gain);
+        oscillator.modulationIndex = read(handles.modulationIndex);
+
+        // zmiana na sek, sustain z dB na gain
+        envelope.attack = read(handles.attack) * 0.001f;
+        envelope.decay = read(handles.decay) * 0.001f;
+        envelope.sustain = juce::Decibels::decibelsToGain(read(handles.sustain));
+        envelope.release = read(handles.release) * 0.001f;
+        envelope.curve = curve;
+    }
+
+    next.algorithm = readChoice(algorithm);
+    next.feedback = read(feedback);
+    next.oversampling = readChoice(oversampling);
+    next.precision = readChoice(precision);
+    next.bandLimited = readChoice(waveQuality) == 1;
+    next.modulationMode = readChoice(modulationMode);
+    next.rampTime = read(rampTime) * 0.001f;
+    next.silenceThreshold = juce::Decibels::decibelsToGain(read(silenceThreshold), -200.0f);
+
+    next.filterType = readChoice(filterType);
+    next.filterCutoff = read(filterCutoff);
+    next.filterResonance = read(filterResonance);
+    next.filterEnabled = read(filterEnabled) >= 0.5f;
+    next.filterParaphonic = read(filterParaphonic) >= 0.5f;
+
+    // adsr filtra: sekundy, sustain z procentow
+    next.modEnvelope.attack = read(modAttack) * 0.001f;
+    next.modEnvelope.decay = read(modDecay) * 0.001f;
+    next.modEnvelope.sustain = read(modSustain) / 100.0f;
+    next.modEnvelope.release = read(modRelease) * 0.001f;
+    next.modEnvelope.curve = curve;
+
+    next.vocoderEnabled = read(vocoderEnabled) >= 0.5f;
+    next.smoothingFactor = read(smoothingFactor);
+
+    next.voiceLimit = readChoice(voiceLimit);
+
+    // nowa wersja tylko dla grup ktore sie zmienily
+    if (next.algorithm != snapshot.algorithm || next.feedback != snapshot.feedback
+        || next.oversampling != snapshot.oversampling || next.precision != snapshot.precision
+        || next.bandLimited != snapshot.bandLimited || next.modulationMode != snapshot.modulationMode
+        || next.rampTime != snapshot.rampTime || next.silenceThreshold != snapshot.silenceThreshold)
+        ++next.revisions[PatchSnapshot::voiceGroup];
+
+    for (int op = 0; op < 4; ++op)
+    {
+        if (next.oscillators[op] != snapshot.oscillators[op])
+            ++next.revisions[PatchSnapshot::oscillatorGroup + op];
+
+        if (next.envelopes[op] != snapshot.envelopes[op])
+            ++next.revisions[PatchSnapshot::envelopeGroup + op];
+    }
+
+    if (next.filterType != snapshot.filterType || next.filterCutoff != snapshot.filterCutoff
+        || next.filterResonance != snapshot.filterResonance || next.filterEnabled != snapshot.filterEnabled
+        || next.filterParaphonic != snapshot.filterParaphonic)
+        ++next.revisions[PatchSnapshot::filterGroup];
+
+    if (next.modEnvelope != snapshot.modEnvelope)
+        ++next.revisions[PatchSnapshot::modEnvelopeGroup];
+
+    snapshot = next;
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    ParameterRegistry.h
+    Created: 17 Oct 2026 11:04:52pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// parametry jednego operatora i jego obwiedni, juz w jednostkach glosu (sekundy, gain)
+struct OscillatorPatch
+{
+    int waveType;
+    float coarse, fine, gain;
+    float modulationIndex;
+};
+
+struct EnvelopePatch
+{
+    float attack, decay, sustain, release;
+    int curve;      // AdsrData::Curve, wspolny dla wszystkich obwiedni
+};
+
+// wartosci wszystkich parametrow z jednego bloku - czytane przez wszystkie glosy, bez apvts i napisow
+struct PatchSnapshot
+{
+    // grupy parametrow z osobna wersja - glos przelicza tylko grupy zmienione od ostatniego razu
+    enum Group
+    {
+        voiceGroup = 0,                         // algorytm, sprzezenie, nadprobkowanie, dokladnosc, tryb modulacji, rampy
+        oscillatorGroup,                        // osc1..osc4
+        envelopeGroup = oscillatorGroup + 4,    // adsr osc1..osc4
+        filterGroup = envelopeGroup + 4,
+        modEnvelopeGroup,
+        numGroups
+    };
+
+    OscillatorPatch oscillators[4];
+    EnvelopePatch envelopes[4];
+
+    int algorithm;
+    float feedback;
+    int oversampling;       // OversamplingData::Mode
+    int precision;          // OperatorKernel::Precision
+    bool bandLimited;
+    int modulationMode;     // OperatorKernel::ModulationMode
+    float rampTime;         // wygladzanie automatyzacji w sekundach
+    float silenceThreshold; // prog ciszy zwalniania glosow (gain)
+
+    int filterType;
+    float filterCutoff, filterResonance;
+    bool filterEnabled;
+    bool filterParaphonic;  // jeden filtr na miksie glosow zamiast filtra w kazdym glosie
+    EnvelopePatch modEnvelope;
+
+    bool vocoderEnabled;
+    float smoothingFactor;
+
+    int voiceLimit;
+
+    juce::uint32 revisions[numGroups];
+};
+
+// wskazniki na wartosci parametrow apvts szukane raz w konstruktorze (napisy tylko tutaj),
+// w watku audio juz tylko odczyt atomikow do PatchSnapshot
+class ParameterRegistry
+{
+public:
+    explicit ParameterRegistry(juce::AudioProcessorValueTreeState& apvts);
+
+    // raz na blok, bez alokacji - zmienione grupy dostaja nowa wersje w snapshot.revisions
+    void makeSnapshot(PatchSnapshot& snapshot) const noexcept;
+
+private:
+    using Handle = const std::atomic<float>*;
+
+    struct OperatorHandles
+    {
+        Handle waveType, coarse, fine, gain, modulationIndex;
+        Handle attack, decay, sustain, release;
+    };
+
+    OperatorHandles operators[4];
+
+    Handle algorithm, feedback, oversampling, precision, waveQuality, modulationMode, rampTime, silenceThreshold;
+    Handle filterType, filterCutoff, filterResonance, filterEnabled, filterParaphonic;
+    Handle modAttack, modDecay, modSustain, modRelease, envelopeCurve;
+    Handle vocoderEnabled, smoothingFactor;
+    Handle voiceLimit;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterRegistry)
+};
@@ -35,7 +35,7 @@ FM_SYNTHAudioProcessorEditor::FM_SYNTHAudioProcessorEditor(FM_SYNTHAudioProcesso
     // smoothing slider
     smoothingLabel.setText("Smoothing Factor", juce::dontSendNotification);
     smoothingLabel.setColour(juce::Label::textColourId, juce::Colours::white);
-    addAndMakeVisible(smoothingLabel);
+    content.addAndMakeVisible(smoothingLabel);
 
     smoothingSlider.setSliderStyle(juce::Slider::SliderStyle::LinearHorizontal);
     smoothingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
@@ -44,10 +44,15 @@ FM_SYNTHAudioProcessorEditor::FM_SYNTHAudioProcessorEditor(FM_SYNTHAudioProcesso
     smoothingSlider.setColour(juce::Slider::thumbColourId, juce::Colours::grey);
     smoothingSlider.setColour(juce::Slider::backgroundColourId, juce::Colours::darkgrey);
 
-    addAndMakeVisible(smoothingSlider);
+    content.addAndMakeVisible(smoothingSlider);
 
     smoothingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.apvts, "SMOOTHFAC", smoothingSlider);
 
+    // liczba glosow i obciazenie rdzenia audio
+    perfLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    perfLabel.setJustificationType(juce::Justification::right);
+    content.addAndMakeVisible(perfLabel);
+
     // adsr
     adsr1 = std::make_unique<AdsrComponent>("Osc 1 Envelope", audioProcessor.apvts, "OSC1ATTACK", "OSC1DECAY", "OSC1SUSTAIN", "OSC1RELEASE", 1);
     adsr2 = std::make_unique<AdsrComponent>("Osc 2 Envelope", audioProcessor.apvts, "OSC2ATTACK", "OSC2DECAY", "OSC2SUSTAIN", "OSC2RELEASE", 2);
@@ -56,8 +61,12 @@ FM_SYNTHAudioProcessorEditor::FM_SYNTHAudioProcessorEditor(FM_SYNTHAudioProcesso
 
     // oscilloscope
     oscilloscope = std::make_unique<OscilloscopeComponent>();
-    addAndMakeVisible(*oscilloscope);
-    startTimerHz(60);
+    content.addAndMakeVisible(*oscilloscope);
+    scopeSamples.resize((size_t)ScopeBuffer::maxReadSamples);
+
+    // widmo - FFT w watku analizatora, tylko gdy edytor jest widoczny
+    spectrum = std::make_unique<SpectrumComponent>(audioProcessor.getSpectrumAnalyser());
+    content.addAndMakeVisible(*spectrum);
 
     // obrazki do selektora algorytmow
     std::vector<juce::Image> algorithmImages;
@@ -72,27 +81,40 @@ FM_SYNTHAudioProcessorEditor::FM_SYNTHAudioProcessorEditor(FM_SYNTHAudioProcesso
 
     // selektor algorytmu
     genericAlgSelector = std::make_unique<GenericImageSelector>(audioProcessor.apvts, "ALGORITHM", algorithmImages, 1111);
-    addAndMakeVisible(*genericAlgSelector);
+    content.addAndMakeVisible(*genericAlgSelector);
+    genericAlgSelector->setBufferedToImage(true);
 
     // do widoku
-    addAndMakeVisible(*osc1);
-    addAndMakeVisible(*osc2);
-    addAndMakeVisible(*osc3);
-    addAndMakeVisible(*osc4);
-    addAndMakeVisible(*adsr1);
-    addAndMakeVisible(*adsr2);
-    addAndMakeVisible(*adsr3);
-    addAndMakeVisible(*adsr4);
-    addAndMakeVisible(filter);
-    addAndMakeVisible(modAdsr);
-    addAndMakeVisible(vocoderToggle);
-
-    setSize(1100, 1000);
+    content.addAndMakeVisible(*osc1);
+    content.addAndMakeVisible(*osc2);
+    content.addAndMakeVisible(*osc3);
+    content.addAndMakeVisible(*osc4);
+    content.addAndMakeVisible(*adsr1);
+    content.addAndMakeVisible(*adsr2);
+    content.addAndMakeVisible(*adsr3);
+    content.addAndMakeVisible(*adsr4);
+    content.addAndMakeVisible(filter);
+    content.addAndMakeVisible(modAdsr);
+    content.addAndMakeVisible(vocoderToggle);
+
+    // uklad w stalym rozmiarze projektu, okno edytora tylko go skaluje
+    content.setBounds(0, 0, designWidth, designHeight);
+    layoutContent();
+    addAndMakeVisible(content);
+
+    setResizable(true, true);
+    setResizeLimits(designWidth / 2, designHeight / 2, designWidth * 2, designHeight * 2);
+    getConstrainer()->setFixedAspectRatio((double)designWidth / (double)designHeight);
+    setSize(designWidth, designHeight);
+
+    // timer i watek analizatora startuja dopiero gdy edytor jest widoczny
+    updateRefreshState();
 }
 
 
 FM_SYNTHAudioProcessorEditor::~FM_SYNTHAudioProcessorEditor()
 {
+    audioProcessor.getSpectrumAnalyser().stopThread(1000);
 }
 
 void FM_SYNTHAudioProcessorEditor::paint(juce::Graphics& g)
@@ -101,6 +123,45 @@ void FM_SYNTHAudioProcessorEditor::paint(juce::Graphics& g)
 }
 
 void FM_SYNTHAudioProcessorEditor::resized()
+{
+    // skala zamiast nowego ukladu - panele w pamieci przerysowywane raz na zmiane skali
+    const float scale = juce::jmin((float)getWidth() / (float)designWidth, (float)getHeight() / (float)designHeight);
+    content.setTransform(juce::AffineTransform::scale(scale));
+}
+
+void FM_SYNTHAudioProcessorEditor::visibilityChanged()
+{
+    updateRefreshState();
+}
+
+void FM_SYNTHAudioProcessorEditor::parentHierarchyChanged()
+{
+    updateRefreshState();
+}
+
+void FM_SYNTHAudioProcessorEditor::updateRefreshState()
+{
+    const bool showing = isShowing();
+    if (showing == refreshing && isTimerRunning())
+        return;
+
+    refreshing = showing;
+    auto& analyser = audioProcessor.getSpectrumAnalyser();
+
+    if (showing)
+    {
+        analyser.startThread(juce::Thread::Priority::low);
+        startTimerHz(refreshRateHz);
+    }
+    else
+    {
+        // ukryty (np. zminimalizowane okno hosta) - bez FFT i rysowania, tylko rzadkie sprawdzanie czy wrocil
+        analyser.stopThread(1000);
+        startTimerHz(hiddenPollRateHz);
+    }
+}
+
+void FM_SYNTHAudioProcessorEditor::layoutContent()
 {
     const auto oscWidth = 530;
     const auto oscHeight = 160;
@@ -124,8 +185,10 @@ void FM_SYNTHAudioProcessorEditor::resized()
 
     smoothingLabel.setBounds(vocoderToggle.getRight() + 10, vocoderToggle.getY(), 200, vocoderToggle.getHeight());
     smoothingSlider.setBounds(smoothingLabel.getRight() - 70, vocoderToggle.getY(), 300, vocoderToggle.getHeight());
+    perfLabel.setBounds(smoothingSlider.getRight() + padding, vocoderToggle.getY(), designWidth - smoothingSlider.getRight() - 2 * padding, vocoderToggle.getHeight());
 
-    oscilloscope->setBounds(0, vocoderToggle.getBottom() + padding, 1100, 100);
+    oscilloscope->setBounds(0, vocoderToggle.getBottom() + padding, 545, 100);
+    spectrum->setBounds(oscilloscope->getRight() + padding, oscilloscope->getY(), designWidth - oscilloscope->getRight() - padding, 100);
 
     // selektor algorytmu
     genericAlgSelector->setBounds(modAdsr.getRight() + padding, modAdsr.getBottom() - 125, 350, 125);
@@ -133,9 +196,23 @@ void FM_SYNTHAudioProcessorEditor::resized()
 
 void FM_SYNTHAudioProcessorEditor::timerCallback()
 {
-    // pobierz bufor oscyloskopowy z procesora
-    juce::AudioBuffer<float> oscBuffer;
-    audioProcessor.getOscilloscopeBuffer(oscBuffer);
+    // host mogl schowac okno bez zadnego powiadomienia
+    updateRefreshState();
+    if (!refreshing)
+        return;
+
+    // statystyki odswiezane kilka razy na sekunde
+    if (++perfUpdateCounter >= refreshRateHz / 4)
+    {
+        perfUpdateCounter = 0;
+        const int voices = audioProcessor.getNumActiveVoices();
+        const double load = audioProcessor.getCpuLoad() * 100.0;
+        juce::String text = "Voices: " + juce::String(voices) + "   CPU: " + juce::String(load, 1) + " %";
+        if (voices > 0)
+            text << "  (" << juce::String(load / voices, 2) << " % / voice)";
+        text << "   Recalc: " << juce::String(juce::roundToInt(audioProcessor.getRecomputesPerSecond())) << " /s";
+        perfLabel.setText(text, juce::dontSendNotification);
+    }
 
     // pobierz aktualna czestotliwosc z procesora
     float currentFrequency = audioProcessor.getCurrentFrequency();
@@ -143,19 +220,15 @@ void FM_SYNTHAudioProcessorEditor::timerCallback()
     // okres = sampleRate / frequency
     int periodSamples = static_cast<int>(sampleRate / currentFrequency);
 
-    // liczba probka ma sie miescic w dostepncyh probkach
-    periodSamples = juce::jlimit(1, oscBuffer.getNumSamples(), periodSamples);
+    // okres wyswietlany + drugi tyle do szukania zbocza - razem ma sie miescic w przygotowanym buforze
+    periodSamples = juce::jlimit(16, (int)scopeSamples.size() / 2, periodSamples);
+    const int windowSamples = periodSamples * 2;
 
-    // wektor z probkami
-    std::vector<float> samples(periodSamples);
-    if (oscBuffer.getNumChannels() > 0)
-    {
-        const float* data = oscBuffer.getReadPointer(0);
-
-        int startSample = oscBuffer.getNumSamples() - periodSamples;
-        std::copy(data + startSample, data + startSample + periodSamples, samples.begin());
-    }
+    // ostatnie probki wyjscia bez blokowania watku audio i bez alokacji - gdy ramka przepadla, zostaje poprzednia
+    if (audioProcessor.readOscilloscope(scopeSamples.data(), windowSamples))
+        oscilloscope->pushSamples(scopeSamples.data(), windowSamples, periodSamples);
 
-    // probki -> oscilloscope
-    oscilloscope->pushSamples(samples.data(), periodSamples);
+    // oscyloskop i widmo bez wlasnych timerow - odrysowuja tylko swoj obszar, gdy maja cos nowego
+    oscilloscope->refresh();
+    spectrum->refresh();
 }
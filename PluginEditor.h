@@ -14,6 +14,7 @@
 #include "UI/OscComponent.h"
 #include "UI/FilterComponent.h"
 #include "UI/OscilloscopeComponent.h"
+#include "UI/SpectrumComponent.h"
 #include "UI/ImageSelector.h"  
 
 class FM_SYNTHAudioProcessorEditor : public juce::AudioProcessorEditor, public juce::Timer
@@ -25,9 +26,22 @@ public:
     void paint(juce::Graphics&) override;
     void resized() override;
     void timerCallback() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
 private:
+    // rozmiar, w ktorym rozlozone sa panele
+    static constexpr int designWidth = 1100;
+    static constexpr int designHeight = 1000;
+    static constexpr int refreshRateHz = 30;
+    static constexpr int hiddenPollRateHz = 2;
+
+    void layoutContent();
+    void updateRefreshState();
+
     FM_SYNTHAudioProcessor& audioProcessor;
+    juce::Component content;            // wszystkie panele, skalowany transformacja
+    bool refreshing = false;
     std::unique_ptr<OscComponent> osc1, osc2, osc3, osc4;
     std::unique_ptr<AdsrComponent> adsr1, adsr2, adsr3, adsr4;
     FilterComponent filter;
@@ -40,7 +54,12 @@ private:
     juce::Label smoothingLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> smoothingAttachment;
 
+    juce::Label perfLabel;
+    int perfUpdateCounter = 0;
+
     std::unique_ptr<OscilloscopeComponent> oscilloscope;
+    std::vector<float> scopeSamples;    // jeden okres z procesora, rozmiar staly od konstruktora
+    std::unique_ptr<SpectrumComponent> spectrum;
 
     std::unique_ptr<GenericImageSelector> genericAlgSelector;
 
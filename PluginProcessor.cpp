@@ -21,17 +21,21 @@ FM_SYNTHAudioProcessor::FM_SYNTHAudioProcessor()
     ),
     apvts(*this, nullptr, "Parameters", createParameters())
 {
+    parameters.makeSnapshot(patch);
     synth.addSound(new SynthSound());
-    synth.addVoice(new SynthVoice());
-    //for (int i = 0; i < 8; ++i)
-    //{
-    //    synth.addVoice(new SynthVoice());
-    //}
 
+    // glosy tworzone w prepareToPlay, tu tylko parametry dla nowej nuty
+    synth.onVoiceStart = [this](SynthVoice& voice) { voice.applyPatch(patch); };
+
+    apvts.addParameterListener("THREADS", this);
+    apvts.addParameterListener("OVERSAMPLING", this);
 }
 
 FM_SYNTHAudioProcessor::~FM_SYNTHAudioProcessor()
 {
+    apvts.removeParameterListener("THREADS", this);
+    apvts.removeParameterListener("OVERSAMPLING", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -99,23 +103,37 @@ void FM_SYNTHAudioProcessor::changeProgramName(int index, const juce::String& ne
 //==============================================================================
 void FM_SYNTHAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    synth.setCurrentPlaybackSampleRate(sampleRate);
-
-    for (int i = 0; i < synth.getNumVoices(); i++)
-    {
-        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
-        {
-            voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
-        }
-    }
+    // glosy, filtr parafoniczny i vocoder licza mono - na kanaly wyjscia dopiero na koncu processBlock
+    synth.setRenderThreadLimit(getThreadLimitParameter());
+    synth.prepareVoices(sampleRate, samplesPerBlock, 1);
+    parameters.makeSnapshot(patch);
+    updateLatency();
 
     vocoder.prepareToPlay(sampleRate, samplesPerBlock);
+    spectrumAnalyser.setSampleRate(sampleRate);
+    prepareBlockScratch(samplesPerBlock);
+    loadMeasurer.reset(sampleRate, samplesPerBlock);
+}
+
+void FM_SYNTHAudioProcessor::prepareBlockScratch(int samplesPerBlock)
+{
+    // modBuffer i carrierBuffer
+    scratchBlockSize = juce::jmax(1, samplesPerBlock);
+    blockScratch.prepare(2 * ScratchArena::getAllocationSize((size_t)scratchBlockSize));
+
+    // zdarzenia MIDI kawalka (ensureSize liczy bajty): do 4 krotkich zdarzen na probke kawalka,
+    // zdarzenie 3-bajtowe zajmuje w MidiBuffer 9 bajtow (czas + dlugosc + dane) - gesciej albo sysex alokuje
+    constexpr int maxChunkEventsPerSample = 4;
+    constexpr int shortEventBytes = (int)(sizeof(juce::int32) + sizeof(juce::uint16)) + 3;
+    chunkMidiCapacity = scratchBlockSize * maxChunkEventsPerSample * shortEventBytes;
+    chunkMidi.ensureSize((size_t)chunkMidiCapacity);
 }
 
 void FM_SYNTHAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    synth.releaseWorkers();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -148,7 +166,7 @@ void FM_SYNTHAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-
+    juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(loadMeasurer, buffer.getNumSamples());
 
 
     const int totalNumInputChannels = getTotalNumInputChannels();
@@ -159,101 +177,123 @@ void FM_SYNTHAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (int ch = totalNumInputChannels; ch < totalNumOutputChannels; ++ch)
         buffer.clear(ch, 0, numSamples);
 
-    // pobranie sygnalu z mikrofonu do bufora
-    juce::AudioBuffer<float> modBuffer;
-    modBuffer.setSize(1, numSamples);
-    if (totalNumInputChannels > 0)
-        modBuffer.copyFrom(0, 0, buffer, 0, 0, numSamples);   // wejście-L -> modulator
-    else
-        modBuffer.clear();
+    // wszystkie parametry raz na blok - glosy (takze nowe nuty w renderNextBlock) czytaja juz tylko patch
+    parameters.makeSnapshot(patch);
+
+    // konfiguracja aktywnych voices
+    synth.setVoiceLimit(patch.voiceLimit);
+
+    for (auto* voice = synth.getFirstActiveVoice(); voice != nullptr; voice = voice->getNextActiveVoice())
+        voice->applyPatch(patch);
+
+    // paramtery vocodera
+    vocoder.setSmoothingFactor(patch.smoothingFactor);
 
-    // konfiguracja wszystkich voices
-    for (int v = 0; v < synth.getNumVoices(); ++v)
+    if (numSamples <= scratchBlockSize)
     {
-        if (auto* voice = dynamic_cast<SynthVoice*> (synth.getVoice(v)))
+        renderChunk(buffer, midiMessages, 0, numSamples);
+    }
+    else
+    {
+        // host dal wiekszy blok niz zapowiedzial w prepareToPlay - po kawalkach tej wielkosci, bez nowych buforow
+        // (Synthesiser obsluguje po swoim zakresie wszystkie dalsze zdarzenia, wiec kazdy kawalek dostaje tylko swoje;
+        // MIDI kawalka miesci sie w zapasie z prepareBlockScratch, o ile nie ma sysex ani wiecej niz 4 zdarzen na probke)
+        for (int start = 0; start < numSamples; start += scratchBlockSize)
         {
-            // algorytm
-            auto& algoParam = *apvts.getRawParameterValue("ALGORITHM");
-            voice->setAlgorithm(static_cast<int> (algoParam.load()));
-
-            // osc i adsr
-            for (int oscIndex = 1; oscIndex <= 4; ++oscIndex)
-            {
-                // parametry osc
-                auto& waveType = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "WAVETYPE");
-                auto& coarse = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "COARSE");
-                auto& fine = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "FINE");
-                auto& gain = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "GAIN");
-
-                auto& osc = voice->getOscillator(oscIndex);
-                osc.setWaveType(static_cast<int> (waveType.load()));
-                osc.setCoarse(coarse.load());
-                osc.setFine(fine.load());
-                osc.setGain(gain.load());
-                osc.setBaseFreqParams(voice->getBaseFrequency(), coarse.load(), fine.load());
-
-                // paramtery adsr
-                auto& attack = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "ATTACK");  
-                auto& decay = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "DECAY");   
-                auto& sustain = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "SUSTAIN");  
-                auto& release = *apvts.getRawParameterValue("OSC" + std::to_string(oscIndex) + "RELEASE");  
-
-                // zmiana na sek
-                float aSec = attack.load() * 0.001f;                
-                float dSec = decay.load() * 0.001f;
-                float rSec = release.load() * 0.001f;
-                float sAmp = juce::Decibels::decibelsToGain(sustain.load()); 
-
-                voice->updateAdsr(oscIndex, aSec, dSec, sAmp, rSec);
-            }
-
-            // paramtery filtra
-            auto& filterType = *apvts.getRawParameterValue("FILTERTYPE");
-            auto& cutoff = *apvts.getRawParameterValue("FILTERFREQ");
-            auto& resonance = *apvts.getRawParameterValue("FILTERRES");
-            voice->updateFilter(filterType.load(), cutoff.load(), resonance.load());
-
-            auto& filterOn = *apvts.getRawParameterValue("FILTERON");
-            voice->setFilterEnabled(filterOn.load());
-
-            // paramtery adsra filtra
-            auto& modAttack = *apvts.getRawParameterValue("MODATTACK");  
-            auto& modDecay = *apvts.getRawParameterValue("MODDECAY");   
-            auto& modSustain = *apvts.getRawParameterValue("MODSUSTAIN"); 
-            auto& modRelease = *apvts.getRawParameterValue("MODRELEASE"); 
-
-            float mASec = modAttack.load() * 0.001f;       
-            float mDSec = modDecay.load() * 0.001f;
-            float mRSec = modRelease.load() * 0.001f;
-            float mSSustain = modSustain.load() / 100.0f;   
-
-            voice->updateModAdsr(mASec, mDSec, mSSustain, mRSec);
+            const int chunkSize = juce::jmin(scratchBlockSize, numSamples - start);
+
+            chunkMidi.clear();
+            chunkMidi.addEvents(midiMessages, start, chunkSize, -start);
+            jassert(chunkMidi.data.size() <= chunkMidiCapacity); // wiecej zdarzen niz zapas z prepareToPlay - alokacja w watku audio
+            renderChunk(buffer, chunkMidi, start, chunkSize);
         }
     }
 
-    // wygenerowanie sygnalu
-    juce::AudioBuffer<float> carrierBuffer;
-    carrierBuffer.setSize(totalNumOutputChannels, numSamples);
+    // statystyki dla UI
+    numActiveVoices.store(synth.getNumActiveVoices());
+    updateRecomputeRate(numSamples);
+    if (auto* voice = synth.getFirstActiveVoice())
+        currentFrequency.store(voice->getBaseFrequency());
+}
+
+void FM_SYNTHAudioProcessor::renderChunk(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages,
+    int startSample, int numSamples)
+{
+    const int totalNumInputChannels = getTotalNumInputChannels();
+    const int totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // bufory kawalka z areny, AudioBuffer tylko na nie wskazuje
+    ScratchArena::ScopedRewind rewind(blockScratch);
+    float* modData = blockScratch.allocate((size_t)numSamples);
+    float* carrierData = blockScratch.allocate((size_t)numSamples);
+
+    // arena mniejsza niz kawalek (nie powinno sie zdarzyc) - cisza zamiast pisania za bufor
+    if (modData == nullptr || carrierData == nullptr)
+    {
+        buffer.clear(startSample, numSamples);
+        return;
+    }
+
+    // pobranie sygnalu z mikrofonu do bufora
+    juce::AudioBuffer<float> modBuffer(&modData, 1, numSamples);
+    if (totalNumInputChannels > 0)
+        modBuffer.copyFrom(0, 0, buffer, 0, startSample, numSamples);   // wejście-L -> modulator
+    else
+        modBuffer.clear();
+
+    // wygenerowanie sygnalu (mono - bez panoramy wszystkie kanaly i tak sa takie same)
+    juce::AudioBuffer<float> carrierBuffer(&carrierData, 1, numSamples);
     carrierBuffer.clear();
     synth.renderNextBlock(carrierBuffer, midiMessages, 0, numSamples);
 
-    // paramtery vocodera
-    vocoder.setSmoothingFactor(*apvts.getRawParameterValue("SMOOTHFAC"));
+    // wyjscie kawalka - widok na kanaly hosta od startSample
+    juce::AudioBuffer<float> output(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, numSamples);
 
-    bool vocoderEnabled = *apvts.getRawParameterValue("VOCODER");
-    if (vocoderEnabled)
+    if (patch.vocoderEnabled)
     {
-        vocoder.process(modBuffer, carrierBuffer, buffer);      // OUT -> buffer
+        vocoder.process(modBuffer, carrierBuffer, output);      // OUT -> buffer
     }
     else
     {
         for (int ch = 0; ch < totalNumOutputChannels; ++ch)
-            buffer.copyFrom(ch, 0, carrierBuffer, ch, 0, numSamples);
+            output.copyFrom(ch, 0, carrierBuffer, 0, 0, numSamples);
     }
 
-    updateOscilloscopeBuffer(buffer);
+    // kanal 0 - wszystkie kanaly wyjscia niosa ten sam mono sygnal
+    if (totalNumOutputChannels > 0)
+        oscilloscopeFeed.push(output.getReadPointer(0), numSamples);
+}
+
+void FM_SYNTHAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    // moze przyjsc z watku audio (automatyzacja) - sama zmiana dopiero w watku wiadomosci
+    triggerAsyncUpdate();
+}
+
+void FM_SYNTHAudioProcessor::handleAsyncUpdate()
+{
+    // pomocnicy tworzeni/zatrzymywani tutaj, nigdy w processBlock
+    synth.setRenderThreadLimit(getThreadLimitParameter());
+
+    // zmiana trybu nadprobkowania zmienia latencje - host dostaje ja stad, nie z processBlock
+    updateLatency();
 }
 
+int FM_SYNTHAudioProcessor::getThreadLimitParameter() const
+{
+    return juce::roundToInt(apvts.getRawParameterValue("THREADS")->load());
+}
+
+void FM_SYNTHAudioProcessor::updateLatency()
+{
+    // stala dla trybu - glosy z mniejszym faktorem sa opoznione do latencji najwiekszego
+    // tryb z parametru, nie z patcha (patch nalezy do watku audio)
+    const int mode = juce::roundToInt(apvts.getRawParameterValue("OVERSAMPLING")->load());
+    const int latency = OversamplingData::getLatency(OversamplingData::getMaxFactor(mode));
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
 
 //==============================================================================
 bool FM_SYNTHAudioProcessor::hasEditor() const
@@ -310,6 +350,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout FM_SYNTHAudioProcessor::crea
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
             "OSC" + std::to_string(i) + "GAIN", "Osc " + std::to_string(i) + " Gain",
             juce::NormalisableRange<float>{0.0f, 1.0f, 0.01f}, 0.0f));
+
+        // czulosc operatora na modulacje: FM - mnoznik dewiacji, PM - radiany na jednostke modulacji
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            "OSC" + std::to_string(i) + "INDEX", "Osc " + std::to_string(i) + " Mod Index",
+            juce::NormalisableRange<float>{0.0f, 10.0f, 0.01f, 0.5f}, 1.0f));
     }
 
     //ADSR
@@ -335,6 +380,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout FM_SYNTHAudioProcessor::crea
     params.push_back(std::make_unique<juce::AudioParameterFloat>("MODSUSTAIN", "Mod Sustain", juce::NormalisableRange<float>{0.0f, 100.0f, 0.1f}, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("MODRELEASE", "Mod Release", juce::NormalisableRange<float>{1.0f, 6000.0f, 0.1f, 0.20f}, 1.0f));
 
+    // ksztalt etapow wszystkich obwiedni: liniowe jak dotad albo wykladnicze (analogowe)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("ENVCURVE", "Envelope Curve",
+        juce::StringArray{ "Linear", "Exponential" }, AdsrData::linearCurve));
+
     //FILTER
     params.push_back(std::make_unique<juce::AudioParameterChoice>("FILTERTYPE", "Filter Type", juce::StringArray{ "Low-pass", "Band-pass", "High-pass" }, 0));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("FILTERFREQ", "Filter Freq", juce::NormalisableRange<float> {20.0f, 20000.0f, 1.0f, 0.6f}, 20.0f));
@@ -349,7 +398,47 @@ juce::AudioProcessorValueTreeState::ParameterLayout FM_SYNTHAudioProcessor::crea
         juce::StringArray{ "Alg 1", "Alg 2", "Alg 3", "Alg 4", "Alg 5", "Alg 6", "Alg 7", "Alg 8" },
         0));                    
 
+    // dokladnosc sinusa/trojkata - nizsza dla duzej polifonii
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("PRECISION", "Oscillator Precision",
+        juce::StringArray{ "Exact", "Polynomial", "Table" }, 0));
+
+    // pila/kwadrat/trojkat: naiwne albo z korekcja PolyBLEP/PolyBLAMP (mniej aliasingu przy wysokim COARSE)
+    // domyslnie naiwne - stare sesje brzmia jak dotad
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("WAVEQUALITY", "Wave Quality",
+        juce::StringArray{ "Naive", "PolyBLEP" }, 0));
+
+    // nadprobkowanie operatorow: Auto - kazdy glos wg szerokosci widma (nosne, COARSE, gain), tylko przy nowej nucie
+    // domyslnie 1x - bez latencji, stare sesje graja jak przed nadprobkowaniem
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("OVERSAMPLING", "Oversampling",
+        juce::StringArray{ "Auto", "1x", "2x", "4x" }, OversamplingData::mode1x));
+
+    // FM: modulacja zmienia przyrost fazy (z DC-blokerem), PM: modulacja przesuwa faze jak w DX7
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("MODMODE", "Modulation Mode",
+        juce::StringArray{ "FM", "PM" }, OperatorKernel::frequencyModulation));
+
+    // sprzezenie osc4 na siebie, 0 = bez sprzezenia
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("FEEDBACK", "Feedback",
+        juce::NormalisableRange<float>{0.0f, 4.0f, 0.01f}, 0.0f));
+
     params.push_back(std::make_unique<juce::AudioParameterBool>("FILTERON", "Filter On", false));
+    // jeden filtr po zmiksowaniu glosow, obwiednia filtra z ostatnio zagranego glosu
+    params.push_back(std::make_unique<juce::AudioParameterBool>("FILTERPARA", "Filter Paraphonic", false));
+
+    // wygladzanie automatyzacji gainu operatorow i odciecia filtra w trakcie nuty (ms), 0 = skok raz na blok
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("RAMPTIME", "Automation Smoothing",
+        juce::NormalisableRange<float>{0.0f, 200.0f, 0.1f, 0.5f}, 20.0f));
+
+    // puszczony glos cichszy niz prog przez 50 ms wraca do puli (dBFS wyjscia glosu)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("SILENCE", "Silence Threshold",
+        juce::NormalisableRange<float>{-144.0f, -48.0f, 1.0f}, -96.0f));
+
+    // polifonia - pula glosow jest zawsze pelna, to tylko limit
+    params.push_back(std::make_unique<juce::AudioParameterInt>("VOICES", "Voices",
+        FMSynthesiser::minVoices, FMSynthesiser::maxVoices, 64));
+
+    // watki liczace glosy (1 = tylko watek audio), limit dla wielu instancji w hoscie
+    params.push_back(std::make_unique<juce::AudioParameterInt>("THREADS", "Render threads",
+        1, VoiceWorkerPool::maxWorkers + 1, 1));
 
     return { params.begin(), params.end() };
 }
@@ -357,18 +446,26 @@ juce::AudioProcessorValueTreeState::ParameterLayout FM_SYNTHAudioProcessor::crea
 
 float FM_SYNTHAudioProcessor::getCurrentFrequency() const
 {
-    // zwracanie czestotliwosci pierwszego glosu
-    for (int i = 0; i < synth.getNumVoices(); ++i)
-    {
-        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
-        {
-            if (voice->isVoiceActive())
-                return voice->getBaseFrequency();
-        }
-    }
-    // jak nie jest aktywny to A4
-    return 440.0f;
+    // czestotliwosc pierwszego aktywnego glosu (A4 jak nic nie gra)
+    return numActiveVoices.load() > 0 ? currentFrequency.load() : 440.0f;
 }
 
+void FM_SYNTHAudioProcessor::updateRecomputeRate(int numSamples)
+{
+    // przeliczenia wspolczynnikow glosow usrednione po sekundzie dzwieku
+    recomputeCount += synth.takeRecomputeCount();
+    recomputeSamples += numSamples;
 
+    const double sampleRate = getSampleRate();
+    if (sampleRate > 0.0 && recomputeSamples >= sampleRate)
+    {
+        recomputesPerSecond.store((float)(recomputeCount * sampleRate / recomputeSamples));
+        recomputeCount = 0;
+        recomputeSamples = 0;
+    }
+}
 
+double FM_SYNTHAudioProcessor::getCpuLoad() const
+{
+    return loadMeasurer.getLoadAsProportion();
+}
\ No newline at end of file
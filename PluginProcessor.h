@@ -11,9 +11,16 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "FMSynthesiser.h"
+#include "ParameterRegistry.h"
+#include "ScratchArena.h"
 #include "Data/VocoderData.h"
+#include "Data/ScopeBuffer.h"
+#include "Data/SpectrumAnalyser.h"
 
-class FM_SYNTHAudioProcessor : public juce::AudioProcessor
+class FM_SYNTHAudioProcessor : public juce::AudioProcessor,
+    private juce::AudioProcessorValueTreeState::Listener,
+    private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -53,27 +60,58 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    void updateOscilloscopeBuffer(const juce::AudioBuffer<float>& bufferToCopy)
+    // ostatnie numSamples probek wyjscia (watek UI) - false gdy jeszcze ich nie ma albo ramka przepadla
+    bool readOscilloscope(float* dest, int numSamples) const noexcept
     {
-        const juce::ScopedLock sl(oscLock);
-        oscilloscopeBuffer.makeCopyOf(bufferToCopy);
+        return oscilloscopeFeed.readLatest(dest, numSamples);
     }
 
-    void getOscilloscopeBuffer(juce::AudioBuffer<float>& destBuffer)
-    {
-        const juce::ScopedLock sl(oscLock);
-        destBuffer.makeCopyOf(oscilloscopeBuffer);
-    }
+    // watek analizatora uruchamia edytor - bez otwartego okna widmo nie jest liczone
+    SpectrumAnalyser& getSpectrumAnalyser() noexcept { return spectrumAnalyser; }
     float getCurrentFrequency() const;
 
+    // obciazenie watku audio (0-1) i liczba grajacych glosow
+    double getCpuLoad() const;
+    int getNumActiveVoices() const { return numActiveVoices.load(); }
+    // ile razy na sekunde glosy przeliczaja wspolczynniki (wysokosc, obwiednie, filtr) - przy automatyzacji i bez
+    float getRecomputesPerSecond() const { return recomputesPerSecond.load(); }
+
     juce::AudioProcessorValueTreeState apvts;
 
 private:
-    juce::Synthesiser synth;
+    FMSynthesiser synth;
     VocoderData vocoder;
+
+    // bufory robocze processBlock (modulator vocodera, mono miks glosow) - rezerwowane w prepareToPlay
+    ScratchArena blockScratch;
+    int scratchBlockSize = 0;
+    void prepareBlockScratch(int samplesPerBlock);
+    // jeden kawalek bloku hosta (nie wiekszy niz scratchBlockSize): modulator, synth, vocoder, wyjscie
+    void renderChunk(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages, int startSample, int numSamples);
+    juce::MidiBuffer chunkMidi;         // zdarzenia kawalka przy bloku wiekszym niz zapowiedziany, pamiec z prepareToPlay
+    int chunkMidiCapacity = 0;          // bajty zarezerwowane w chunkMidi
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
-    juce::CriticalSection oscLock;
-    juce::AudioBuffer<float> oscilloscopeBuffer; 
+    void updateRecomputeRate(int numSamples);
+
+    // parametry, ktorych zmiana nie moze sie odbyc w watku audio (tworzenie watkow, latencja) - w watku wiadomosci
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    int getThreadLimitParameter() const;
+
+    // wskazniki parametrow szukane raz, patch odczytywany raz na blok i wspolny dla wszystkich glosow
+    // (glosy przeliczaja tylko grupy ze zmieniona wersja)
+    ParameterRegistry parameters{ apvts };
+    PatchSnapshot patch{};
+    void updateLatency();
+
+    juce::AudioProcessLoadMeasurer loadMeasurer;
+    std::atomic<int> numActiveVoices{ 0 };
+    int recomputeCount = 0;
+    int recomputeSamples = 0;
+    std::atomic<float> recomputesPerSecond{ 0.0f };
+    std::atomic<float> currentFrequency{ 440.0f };
+    ScopeBuffer oscilloscopeFeed;       // wyjscie dla oscyloskopu i analizatora, zapis bez blokad
+    SpectrumAnalyser spectrumAnalyser{ oscilloscopeFeed }; 
 
 
     //==============================================================================
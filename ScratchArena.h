@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    ScratchArena.h
+    Created: 17 Oct 2026 11:58:40pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// pamiec robocza na jeden blok: rezerwowana raz w prepareToPlay, w watku audio tylko przesuwany wskaznik
+// (bez alokatora) - po bloku/zadaniu cofana do zapamietanej pozycji
+class ScratchArena
+{
+public:
+    // tablice wyrownane do linii cache (16 floatow)
+    static constexpr size_t alignment = 16;
+
+    static constexpr size_t getAllocationSize(size_t numFloats) noexcept
+    {
+        return (numFloats + alignment - 1) / alignment * alignment;
+    }
+
+    // nigdy w watku audio
+    void prepare(size_t numFloats)
+    {
+        capacity = getAllocationSize(numFloats);
+        storage.allocate(capacity + alignment, true);
+
+        // poczatek wyrownany niezaleznie od alokatora
+        const auto address = reinterpret_cast<juce::pointer_sized_uint>(storage.get());
+        const auto bytes = alignment * sizeof(float);
+        data = storage.get() + (bytes - address % bytes) % bytes / sizeof(float);
+        position = 0;
+    }
+
+    // nullptr gdy tablica sie nie miesci - wolajacy pomija blok (cisza) zamiast pisac za koniec areny
+    float* allocate(size_t numFloats) noexcept
+    {
+        const size_t size = getAllocationSize(numFloats);
+
+        // rozmiar liczony w prepareToPlay z maksymalnego bloku - tu nie ma juz gdzie urosnac
+        if (size > capacity - position)
+        {
+            jassertfalse;
+            return nullptr;
+        }
+
+        float* block = data + position;
+        position += size;
+        return block;
+    }
+
+    size_t getPosition() const noexcept { return position; }
+    void rewind(size_t marker) noexcept { position = marker; }
+    size_t getCapacity() const noexcept { return capacity; }
+
+    // wszystko przydzielone w zasiegu wraca do areny na koncu zasiegu
+    struct ScopedRewind
+    {
+        explicit ScopedRewind(ScratchArena& a) noexcept : arena(a), marker(a.getPosition()) {}
+        ~ScopedRewind() { arena.rewind(marker); }
+
+        ScratchArena& arena;
+        const size_t marker;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRewind)
+    };
+
+private:
+    juce::HeapBlock<float> storage;
+    float* data = nullptr;
+    size_t capacity = 0;
+    size_t position = 0;
+};
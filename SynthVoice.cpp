@@ -9,7 +9,6 @@
 */
 
 #include "SynthVoice.h"
-#include "Data/FMAlgorithmRouter.h"
 
 bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
 {
@@ -17,12 +16,32 @@ bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
 }
 void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition)
 {
+    // glos jest jeszcze wygaszany po kradziezy - nowa nuta wystartuje po wygaszeniu
+    if (stealFadeRemaining > 0)
+    {
+        pendingNote = midiNoteNumber;
+        pendingNoteReleased = false;
+        return;
+    }
+
+    beginNote(midiNoteNumber);
+}
+void SynthVoice::beginNote(int midiNoteNumber)
+{
+    if (onNoteBegin != nullptr && *onNoteBegin)
+        (*onNoteBegin)(*this);
+
     baseFrequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+    silentSamples = 0;
+
+    // przyrost fazy liczony raz, w updateOversampling razem z faktorem
     osc1.setBaseFrequency(baseFrequency);
     osc2.setBaseFrequency(baseFrequency);
     osc3.setBaseFrequency(baseFrequency);
     osc4.setBaseFrequency(baseFrequency);
 
+    updateOversampling();
+
     osc1.resetPhase();
     osc2.resetPhase();
     osc3.resetPhase();
@@ -33,6 +52,13 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
     osc3.resetModState();
     osc4.resetModState();
 
+    // nowa nuta od razu z aktualnymi wartosciami, rampy tylko dla zmian w trakcie dzwieku
+    osc1.skipGainRamp();
+    osc2.skipGainRamp();
+    osc3.skipGainRamp();
+    osc4.skipGainRamp();
+    cutoffRamp.skip();
+
     adsr1.noteOn();
     adsr2.noteOn();
     adsr3.noteOn();
@@ -40,8 +66,63 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
 
     modAdsr.noteOn();
 }
+void SynthVoice::updateOversampling()
+{
+    // faktor raz na nute - zmiana w trakcie dzwieku dalaby skok w historii filtrow decymacji
+    OscData* oscs[] = { &osc1, &osc2, &osc3, &osc4 };
+    float frequencies[4], gains[4], deviations[4];
+    const bool phaseModulation = osc1.getModulationMode() == OperatorKernel::phaseModulation;
+
+    // ostatnia harmoniczna ksztaltu powyzej -30 dB: sinus, pila i kwadrat (1/k), trojkat (1/k^2)
+    constexpr float harmonicSpan[] = { 1.0f, 32.0f, 32.0f, 6.0f };
+
+    for (int op = 0; op < 4; ++op)
+    {
+        const int waveType = juce::jlimit(0, 3, oscs[op]->getWaveType());
+        frequencies[op] = oscs[op]->getFrequency() * harmonicSpan[waveType];
+        gains[op] = oscs[op]->getGain();
+        deviations[op] = phaseModulation ? oscs[op]->getModulationIndex() : oscs[op]->getFrequencyDeviation();
+    }
+
+    const float bandwidth = OversamplingData::estimateBandwidth(routingMatrix, frequencies, gains, deviations, phaseModulation);
+    const int factor = OversamplingData::chooseFactor(oversamplingMode, bandwidth, currentSampleRate);
+
+    // latencja zawsze jak dla najwiekszego faktoru trybu - glosy nizszego sa opoznione
+    oversampler.setFactor(factor, OversamplingData::getLatency(OversamplingData::getMaxFactor(oversamplingMode)));
+
+    for (auto* osc : oscs)
+        osc->setOversamplingFactor(factor);
+
+    numRecomputations += 4;
+
+    // tempo obwiedni tylko gdy faktor inny niz w poprzedniej nucie
+    if (envelopeRate == currentSampleRate * factor)
+        return;
+
+    envelopeRate = currentSampleRate * factor;
+
+    for (auto* adsr : { &adsr1, &adsr2, &adsr3, &adsr4 })
+        adsr->setSampleRate(envelopeRate);
+
+    numRecomputations += 4;
+}
 void SynthVoice::stopNote(float velocity, bool allowTailOff)
 {
+    // nuta czeka jeszcze na koniec wygaszania
+    if (pendingNote >= 0)
+    {
+        if (allowTailOff)
+        {
+            pendingNoteReleased = true;
+        }
+        else
+        {
+            pendingNote = -1;
+            clearCurrentNote();
+        }
+        return;
+    }
+
     adsr1.noteOff();
     adsr2.noteOff();
     adsr3.noteOff();
@@ -49,9 +130,29 @@ void SynthVoice::stopNote(float velocity, bool allowTailOff)
 
     modAdsr.noteOff();
 
-    if (!allowTailOff || !adsr1.isActive())
+    // twarde zatrzymanie (np. kradziez glosu) - krotkie wygaszenie zamiast klikniecia
+    if (!allowTailOff && areCarriersActive() && stealFadeRemaining == 0)
+        stealFadeRemaining = stealFadeLength;
+
+    if (!allowTailOff || !areCarriersActive())
         clearCurrentNote();
 }
+void SynthVoice::resetVoice()
+{
+    stealFadeRemaining = 0;
+    pendingNote = -1;
+    pendingNoteReleased = false;
+    envelopeLevel = 0.0f;
+
+    adsr1.reset();
+    adsr2.reset();
+    adsr3.reset();
+    adsr4.reset();
+    modAdsr.reset();
+    filter.reset();
+
+    clearCurrentNote();
+}
 void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
 {
 
@@ -76,24 +177,45 @@ void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outpu
     adsr2.setSampleRate(sampleRate);
     adsr3.setSampleRate(sampleRate);
     adsr4.setSampleRate(sampleRate);
+    envelopeRate = sampleRate;
 
     filter.prepareToPlay(sampleRate, samplesPerBlock, outputChannels);
+    cutoffRamp.setRampLength(sampleRate, rampSeconds);
     modAdsr.setSampleRate(sampleRate);
     gain.prepare(spec);
 
+    // reszta tablic etapow z areny watku (attachScratch), tu tylko to co zyje dluzej niz blok
+    maxBlockSize = samplesPerBlock;
+    controlBuffer.setSize(2, samplesPerBlock);
+    mixBuffer.setSize(1, samplesPerBlock);
+    oversampler.prepareToPlay(samplesPerBlock);
+    currentSampleRate = sampleRate;
+
+    stealFadeLength = juce::jmax(1, juce::roundToInt(sampleRate * stealFadeSeconds));
+    silenceHoldLength = juce::jmax(1, juce::roundToInt(sampleRate * silenceHoldSeconds));
+
+    // nowa czestotliwosc - wszystkie parametry do przeliczenia przy nastepnym applyPatch
+    std::fill(std::begin(appliedRevisions), std::end(appliedRevisions), ~0u);
+
     isPrepared = true;
 }
 
-void SynthVoice::updateAdsr(int index, const float attack, const float decay, const float sustain, const float release)
+void SynthVoice::updateAdsr(int index, const float attack, const float decay, const float sustain, const float release,
+    int curve)
 {
+    AdsrData* adsr = nullptr;
+
     switch (index)
     {
-    case 1: adsr1.updateADSR(attack, decay, sustain, release); break;
-    case 2: adsr2.updateADSR(attack, decay, sustain, release); break;
-    case 3: adsr3.updateADSR(attack, decay, sustain, release); break;
-    case 4: adsr4.updateADSR(attack, decay, sustain, release); break;
-    default: jassertfalse;
+    case 1: adsr = &adsr1; break;
+    case 2: adsr = &adsr2; break;
+    case 3: adsr = &adsr3; break;
+    case 4: adsr = &adsr4; break;
+    default: jassertfalse; return;
     }
+
+    adsr->setCurve(curve);
+    adsr->updateADSR(attack, decay, sustain, release);
 }
 
 
@@ -102,75 +224,390 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer,
     int numSamples)
 {
     jassert(isPrepared);
-    if (!isVoiceActive())
+
+    // wygaszanie i czekajaca nuta pisza obwiednie filtra jedna za druga - wspolny filtr czyta caly fragment
+    controlOffset = 0;
+
+    if (stealFadeRemaining > 0)
+    {
+        const int fadeSamples = juce::jmin(numSamples, stealFadeRemaining);
+        renderVoice(outputBuffer, startSample, fadeSamples);
+
+        if (stealFadeRemaining > 0)
+            return;
+
+        // wygaszony - czyscimy stan i startujemy czekajaca nute
+        adsr1.reset();
+        adsr2.reset();
+        adsr3.reset();
+        adsr4.reset();
+        modAdsr.reset();
+        filter.reset();
+        envelopeLevel = 0.0f;
+
+        if (pendingNote >= 0)
+        {
+            beginNote(pendingNote);
+            pendingNote = -1;
+
+            if (pendingNoteReleased)
+            {
+                pendingNoteReleased = false;
+                stopNote(0.0f, true);
+            }
+        }
+
+        startSample += fadeSamples;
+        numSamples -= fadeSamples;
+    }
+
+    if (!isVoiceActive() || numSamples <= 0)
         return;
 
-    synthBuffer.setSize(outputBuffer.getNumChannels(), numSamples, false, false, true);
-    synthBuffer.clear();
+    renderVoice(outputBuffer, startSample, numSamples);
+    updateNoteState();
+}
+
+void SynthVoice::updateNoteState()
+{
+    // koniec nuty: wszystkie nosne wygasly albo po puszczeniu klawisza dluzej cisza ponizej progu
+    // (dlugie release, ktorych juz nie slychac, nie zajmuja glosow)
+    if (!areCarriersActive() || silentSamples >= silenceHoldLength)
+        clearCurrentNote();
+}
+
+bool SynthVoice::areCarriersActive() const noexcept
+{
+    const AdsrData* envelopes[] = { &adsr1, &adsr2, &adsr3, &adsr4 };
+
+    for (int op = 0; op < 4; ++op)
+        if (((routingMatrix.carriers >> op) & 1) && envelopes[op]->isActive())
+            return true;
+
+    return false;
+}
 
-    for (int sample = 0; sample < numSamples; ++sample)
+void SynthVoice::renderVoice(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    // dzielimy na bloki nie dluzsze niz przygotowane bufory
+    while (numSamples > 0)
     {
-        // dla kazdego osc kolejna probka z adsr'a
-        float env1 = adsr1.getNextSample();
-        float env2 = adsr2.getNextSample();
-        float env3 = adsr3.getNextSample();
-        float env4 = adsr4.getNextSample();
+        const int blockSize = juce::jmin(numSamples, maxBlockSize);
+        renderBlock(outputBuffer, startSample, blockSize);
+        startSample += blockSize;
+        numSamples -= blockSize;
+    }
+}
 
-        // aktualny numer algorytmu
-        int algorithmIndex = currentAlgorithm; 
+void SynthVoice::renderBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    jassert(scratch != nullptr);
 
-        // wykonanie funkcji algorytmu sterujacej routingiem modulacji
-        float oscOutput = FMAlgorithmRouter::processAlgorithm(algorithmIndex,
-            osc1, osc2, osc3, osc4,
-            env1, env2, env3, env4);
+    // fragment dluzszy niz controlBuffer (nie z FMSynthesiser) - od poczatku, wspolny filtr i tak go nie czyta
+    if (controlOffset + numSamples > controlBuffer.getNumSamples())
+        controlOffset = 0;
 
-        float processed = oscOutput;
+    // tablice etapow tylko na ten blok
+    ScratchArena::ScopedRewind rewind(*scratch);
+    if (!attachScratch(*scratch, numSamples, controlOffset))
+        return;
 
-        if (filterEnabled)
-        {
-            float modEnvValue = modAdsr.getNextSample(); // 0-1
-            filter.updateParameters(currentFilterType, currentCutoff,
-                currentResonance, modEnvValue);
+    renderEnvelopes(numSamples);
+    renderOperators(numSamples);
+    renderOutput(outputBuffer, startSample, numSamples);
+    controlOffset += numSamples;
+}
 
-            //for (int ch = 0; ch < synthBuffer.getNumChannels(); ++ch)
-                processed = filter.processSample(0, processed);
-        }
+size_t SynthVoice::getScratchSize(int samplesPerBlock) noexcept
+{
+    const auto operatorSamples = (size_t)samplesPerBlock * OversamplingData::maxFactor;
+    return (size_t)outputChannel * ScratchArena::getAllocationSize(operatorSamples)
+        + ScratchArena::getAllocationSize((size_t)samplesPerBlock);
+}
+
+bool SynthVoice::attachScratch(ScratchArena& arena, int numSamples, int controlStart) noexcept
+{
+    jassert(numSamples <= maxBlockSize);
+    jassert(controlStart + numSamples <= controlBuffer.getNumSamples());
+
+    stage[modEnvChannel] = controlBuffer.getWritePointer(0, controlStart);
+    stage[cutoffChannel] = controlBuffer.getWritePointer(1, controlStart);
+
+    // obwiednie i operatory w probkach operatorow, wyjscie glosu w probkach hosta
+    const auto operatorSamples = (size_t)(numSamples * oversampler.getFactor());
+
+    bool allocated = true;
+
+    for (int channel = 0; channel < outputChannel; ++channel)
+    {
+        stage[channel] = arena.allocate(operatorSamples);
+        allocated = allocated && stage[channel] != nullptr;
+    }
 
-        // zapis do bufora
-        for (int ch = 0; ch < synthBuffer.getNumChannels(); ++ch)
-            synthBuffer.setSample(ch, sample, processed);
+    stage[outputChannel] = arena.allocate((size_t)numSamples);
+    return allocated && stage[outputChannel] != nullptr;
+}
 
+void SynthVoice::renderEnvelopes(int numSamples)
+{
+    float* env1 = stage[env1Channel];
+    float* env2 = stage[env2Channel];
+    float* env3 = stage[env3Channel];
+    float* env4 = stage[env4Channel];
+    float* modEnv = stage[modEnvChannel];
+
+    // 1. obwiednie do tablic, operatorow z czestotliwoscia operatorow, filtra z czestotliwoscia hosta
+    const int operatorSamples = numSamples * oversampler.getFactor();
+
+    adsr1.renderBlock(env1, operatorSamples);
+    adsr2.renderBlock(env2, operatorSamples);
+    adsr3.renderBlock(env3, operatorSamples);
+    adsr4.renderBlock(env4, operatorSamples);
+
+    // gain operatorow w trakcie rampy wchodzi do obwiedni - kernel (tez pakowany) dostaje go probka po probce
+    osc1.applyGainRamp(env1, operatorSamples);
+    osc2.applyGainRamp(env2, operatorSamples);
+    osc3.applyGainRamp(env3, operatorSamples);
+    osc4.applyGainRamp(env4, operatorSamples);
+
+    if (filterEnabled)
+    {
+        modAdsr.renderBlock(modEnv, numSamples); // 0-1
+
+        cutoffRamp.fill(stage[cutoffChannel], numSamples);
     }
 
-    DBG("PHASE 1 : " << osc1.getPhase());
-    DBG("PHASE 2 : " << osc2.getPhase());
-    DBG("PHASE 3 : " << osc3.getPhase());
-    DBG("PHASE 4 : " << osc3.getPhase());
+    // glosnosc do kradziezy tylko z obwiedni nosnych
+    const int last = operatorSamples - 1;
+    const float* envelopes[] = { env1, env2, env3, env4 };
+    envelopeLevel = 0.0f;
+
+    for (int op = 0; op < 4; ++op)
+        if ((routingMatrix.carriers >> op) & 1)
+            envelopeLevel = juce::jmax(envelopeLevel, envelopes[op][last]);
+}
+
+void SynthVoice::renderOperators(int numSamples)
+{
+    // 2. operatory w kolejnosci algorytmu
+    OperatorBlocks blocks;
+    blocks.env[0] = stage[env1Channel];
+    blocks.env[1] = stage[env2Channel];
+    blocks.env[2] = stage[env3Channel];
+    blocks.env[3] = stage[env4Channel];
+    blocks.out[0] = stage[out1Channel];
+    blocks.out[1] = stage[out2Channel];
+    blocks.out[2] = stage[out3Channel];
+    blocks.out[3] = stage[out4Channel];
+    blocks.modulation = stage[modulationChannel];
+
+    const int operatorSamples = numSamples * oversampler.getFactor();
+
+    VoiceOperators operators{ { &osc1, &osc2, &osc3, &osc4 } };
+    processRouting(operators, blocks, getOperatorOutputBlock(), operatorSamples);
+
+    for (auto* osc : operators.osc)
+        osc->advancePhaseFraction(operatorSamples);
+
+    decimateOutput(numSamples);
+}
+
+void SynthVoice::decimateOutput(int numSamples)
+{
+    // przy 1x bez opoznienia wejscie == wyjscie i nic sie nie dzieje
+    oversampler.process(getOperatorOutputBlock(), stage[outputChannel], numSamples);
+}
+
+void SynthVoice::renderOutput(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    const float* modEnv = stage[modEnvChannel];
+    const float* cutoff = stage[cutoffChannel];
+    float* voiceOut = stage[outputChannel];
+
+    // 3. filtr na calym bloku, odciecie z obwiedni w tempie kontrolnym (parafoniczny dopiero po miksie)
+    if (filterEnabled && !filterShared)
+    {
+        filter.setTypeAndResonance(currentFilterType, currentResonance);
+        numRecomputations += filter.processBlock(voiceOut, cutoff, modEnv, numSamples);
+    }
 
-    juce::dsp::AudioBlock<float> audioBlock{ synthBuffer };
+    // 4. gain, wygaszanie i jeden miks do wszystkich kanalow
+    auto audioBlock = juce::dsp::AudioBlock<float>(&voiceOut, 1, (size_t)numSamples);
     gain.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
     gain.setGainLinear(0.2f);
 
+    // szczyt bloku po puszczeniu klawisza - updateNoteState zwalnia glos po silenceHoldLength probkach ciszy
+    const auto range = juce::FloatVectorOperations::findMinAndMax(voiceOut, numSamples);
+    if (!isKeyDown() && juce::jmax(-range.getStart(), range.getEnd()) < silenceThreshold)
+        silentSamples += numSamples;
+    else
+        silentSamples = 0;
+
+    // liniowe wygaszenie po kradziezy
+    if (stealFadeRemaining > 0)
+    {
+        jassert(numSamples <= stealFadeRemaining);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            voiceOut[sample] *= (float)(stealFadeRemaining - sample) / (float)stealFadeLength;
+
+        stealFadeRemaining -= numSamples;
+    }
+
     for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
     {
-        outputBuffer.addFrom(channel, startSample, synthBuffer, channel, 0, numSamples);
+        outputBuffer.addFrom(channel, startSample, voiceOut, numSamples);
     }
+}
 
-    if (!adsr1.isActive())
-        clearCurrentNote();
+void SynthVoice::processSharedFilter(FilterData& sharedFilter, juce::dsp::AudioBlock<float> block)
+{
+    jassert((int)block.getNumSamples() <= controlBuffer.getNumSamples());
+
+    sharedFilter.setTypeAndResonance(currentFilterType, currentResonance);
+    numRecomputations += sharedFilter.processBlock(block, controlBuffer.getReadPointer(1),
+        controlBuffer.getReadPointer(0));
+}
+
+void SynthVoice::setAlgorithm(int newAlgorithmIndex, float feedbackAmount)
+{
+    const bool useFeedback = feedbackAmount > 0.0f
+        && juce::isPositiveAndBelow(newAlgorithmIndex, RoutingPresets::numAlgorithms);
+
+    // kompilacja tylko przy zmianie algorytmu, samo wzmocnienie sprzezenia bez kompilacji
+    if (newAlgorithmIndex != currentAlgorithm || useFeedback != useRoutingSchedule)
+    {
+        currentAlgorithm = newAlgorithmIndex;
+        useRoutingSchedule = useFeedback
+            && routingSchedule.compile(RoutingPresets::withFeedback(newAlgorithmIndex, feedbackAmount));
+    }
+
+    currentFeedback = feedbackAmount;
+    routingSchedule.setFeedbackAmount(feedbackAmount);
+
+    const int algorithm = juce::jlimit(0, RoutingPresets::numAlgorithms - 1, newAlgorithmIndex);
+    routingMatrix = useRoutingSchedule ? RoutingPresets::withFeedback(algorithm, feedbackAmount)
+                                       : RoutingPresets::algorithms[algorithm];
+}
+
+void SynthVoice::setSilenceThreshold(float newThresholdGain)
+{
+    silenceThreshold = newThresholdGain;
+}
+
+int SynthVoice::getRoutingKey() const noexcept
+{
+    // algorytm (ze sprzezeniem albo bez) + ksztalty fal, dokladnosc i tryb modulacji czterech operatorow + faktor nadprobkowania
+    int key = currentAlgorithm * 2 + (useRoutingSchedule ? 1 : 0);
+
+    for (const auto* osc : { &osc1, &osc2, &osc3, &osc4 })
+    {
+        key = key * OperatorKernel::numWaves + osc->getKernelWave();
+        key = key * OperatorKernel::numPrecisions + osc->getPrecision();
+        key = key * OperatorKernel::numModulationModes + osc->getModulationMode();
+    }
+
+    // glosy nadprobkowane licza sie tylko z glosami o tym samym faktorze
+    key = key * (OversamplingData::maxFactor + 1) + oversampler.getFactor();
+
+    return key;
+}
+
+void SynthVoice::applyPatch(const PatchSnapshot& patch)
+{
+    auto hasChanged = [this, &patch](int group)
+    {
+        if (appliedRevisions[group] == patch.revisions[group])
+            return false;
+
+        appliedRevisions[group] = patch.revisions[group];
+        ++numRecomputations;
+        return true;
+    };
+
+    // algorytm i ustawienia wspolne dla operatorow
+    const bool voiceChanged = hasChanged(PatchSnapshot::voiceGroup);
+    if (voiceChanged)
+    {
+        setAlgorithm(patch.algorithm, patch.feedback);
+        setOversampling(patch.oversampling);
+        setRampTime(patch.rampTime);
+        setSilenceThreshold(patch.silenceThreshold);
+    }
+
+    // osc i adsr
+    for (int op = 0; op < 4; ++op)
+    {
+        auto& osc = getOscillator(op + 1);
+        const auto& oscillator = patch.oscillators[op];
+
+        if (voiceChanged)
+        {
+            osc.setPrecision(patch.precision);
+            osc.setBandLimited(patch.bandLimited);
+            osc.setModulationMode(patch.modulationMode);
+        }
+
+        if (hasChanged(PatchSnapshot::oscillatorGroup + op))
+        {
+            osc.setWaveType(oscillator.waveType);
+            osc.setGain(oscillator.gain);
+            osc.setModulationIndex(oscillator.modulationIndex);
+
+            // wolny glos dostanie wysokosc dopiero w beginNote
+            if (isVoiceActive())
+                osc.setBaseFreqParams(baseFrequency, oscillator.coarse, oscillator.fine);
+            else
+            {
+                osc.setCoarse(oscillator.coarse);
+                osc.setFine(oscillator.fine);
+            }
+        }
+
+        if (hasChanged(PatchSnapshot::envelopeGroup + op))
+        {
+            const auto& envelope = patch.envelopes[op];
+            updateAdsr(op + 1, envelope.attack, envelope.decay, envelope.sustain, envelope.release, envelope.curve);
+        }
+    }
+
+    // filtr i jego obwiednia
+    if (hasChanged(PatchSnapshot::filterGroup))
+    {
+        updateFilter(patch.filterType, patch.filterCutoff, patch.filterResonance);
+        setFilterEnabled(patch.filterEnabled);
+        setFilterShared(patch.filterParaphonic);
+    }
+
+    if (hasChanged(PatchSnapshot::modEnvelopeGroup))
+    {
+        const auto& envelope = patch.modEnvelope;
+        updateModAdsr(envelope.attack, envelope.decay, envelope.sustain, envelope.release, envelope.curve);
+    }
+}
+
+void SynthVoice::setRampTime(double newRampSeconds)
+{
+    rampSeconds = newRampSeconds;
+
+    for (auto* osc : { &osc1, &osc2, &osc3, &osc4 })
+        osc->setGainRampTime(rampSeconds);
+
+    cutoffRamp.setRampLength(currentSampleRate, rampSeconds);
 }
 
 void SynthVoice::updateFilter(int newFilterType, float newCutoff, float newResonance)
 {
     // zapisz parametry filtra w obiekcie głosu
     currentFilterType = newFilterType;
-    currentCutoff = newCutoff;
+    cutoffRamp.setTargetValue(newCutoff);
     currentResonance = newResonance;
 }
 
 void SynthVoice::updateModAdsr(const float attack, const float decay,
-    const float sustain, const float release)
+    const float sustain, const float release, int curve)
 {
+    modAdsr.setCurve(curve);
     modAdsr.updateADSR(attack, decay, sustain, release);
 }
 OscData& SynthVoice::getOscillator(int index)
@@ -11,10 +11,16 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <functional>
 #include "SynthSound.h"
 #include "Data/OscData.h"
 #include "Data/AdsrData.h"
 #include "Data/FilterData.h"
+#include "Data/RoutingSchedule.h"
+#include "Data/OversamplingData.h"
+#include "Data/ParameterRamp.h"
+#include "ScratchArena.h"
+#include "ParameterRegistry.h"
 
 class SynthVoice : public juce::SynthesiserVoice
 {
@@ -25,21 +31,147 @@ public:
     void controllerMoved(int controllerNumber, int newControllerValue) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     void prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
+    // ile floatow areny watku zajmuje jeden glos na blok samplesPerBlock (przy najwiekszym faktorze)
+    static size_t getScratchSize(int samplesPerBlock) noexcept;
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
 
-    void updateAdsr(int index, const float attack, const float decay, const float sustain, const float release);
+    // curve - AdsrData::Curve
+    void updateAdsr(int index, const float attack, const float decay, const float sustain, const float release,
+        int curve = AdsrData::linearCurve);
     void updateFilter(int newFilterType, float newCutoff, float newResonance);
-    void updateModAdsr(const float attack, const float decay, const float sustain, const float release);
+    void updateModAdsr(const float attack, const float decay, const float sustain, const float release,
+        int curve = AdsrData::linearCurve);
     OscData& getOscillator(int index);
 
-    void setAlgorithm(int newAlgorithmIndex) { currentAlgorithm = newAlgorithmIndex; }
+    // parametry patcha - przeliczane tylko grupy zmienione od ostatniego razu (wszystko po prepareToPlay)
+    void applyPatch(const PatchSnapshot& patch);
+    // ile razy glos przeliczal wspolczynniki (wysokosc, obwiednie, filtr) od ostatniego odczytu
+    int takeRecomputeCount() noexcept
+    {
+        const int count = numRecomputations;
+        numRecomputations = 0;
+        return count;
+    }
+
+    // feedbackAmount > 0 - osc4 moduluje sam siebie, algorytm liczony przez RoutingSchedule
+    void setAlgorithm(int newAlgorithmIndex, float feedbackAmount = 0.0f);
+
+    // OversamplingData::Mode, faktor wybierany przy starcie nuty
+    void setOversampling(int newMode) { oversamplingMode = newMode; }
+    int getOversamplingFactor() const noexcept { return oversampler.getFactor(); }
+
+    // prog ciszy (gain, nie dB) - puszczony glos cichszy przez silenceHoldSeconds jest zwalniany
+    void setSilenceThreshold(float newThresholdGain);
+
+    // czas wygladzania automatyzacji w trakcie nuty (gain operatorow, odciecie filtra), 0 = skok raz na blok
+    void setRampTime(double newRampSeconds);
 
     float getBaseFrequency() const { return baseFrequency; }
     void setFilterEnabled(bool enabled) { filterEnabled = enabled; }
+    // filtr parafoniczny: glos liczy tylko obwiednie i odciecie, filtruje FMSynthesiser po miksie
+    void setFilterShared(bool shared) { filterShared = shared; }
+    bool isFilterShared() const noexcept { return filterEnabled && filterShared; }
+    // wspolny filtr na bloku miksu z obwiednia i odcieciem tego glosu z ostatniego bloku
+    // (caly fragment od 0, takze gdy glos dzielil go na wygaszanie i nowa nute)
+    void processSharedFilter(FilterData& sharedFilter, juce::dsp::AudioBlock<float> block);
+
+    // stan glosu dla puli w FMSynthesiser
+    void resetVoice();
+    bool isFinished() const noexcept { return !isVoiceActive() && stealFadeRemaining == 0; }
+    bool isStealFadeActive() const noexcept { return stealFadeRemaining > 0; }
+    float getEnvelopeLevel() const noexcept { return envelopeLevel; }
+    SynthVoice* getNextActiveVoice() const noexcept { return nextInList; }
 
 private:
+    friend class FMSynthesiser;
+    friend class VoiceList;
+
+    void beginNote(int midiNoteNumber);
+    void updateOversampling();
+    void renderVoice(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+    void renderBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+    // etapy renderBlock osobno - FMSynthesiser liczy operatory kilku glosow naraz
+    // numSamples zawsze w probkach hosta, obwiednie i operatory maja ich numSamples * faktor
+    void renderEnvelopes(int numSamples);
+    void renderOperators(int numSamples);
+    void decimateOutput(int numSamples);
+    void renderOutput(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+    void updateNoteState();
+    // czy ktoras obwiednia nosnej aktualnego algorytmu jeszcze trwa
+    bool areCarriersActive() const noexcept;
+    // tablice etapow z areny na jeden blok - wazne do cofniecia areny, false gdy arena za mala (blok pominiety)
+    // controlStart: gdzie w controlBuffer zaczyna sie ten blok (druga czesc fragmentu po wygaszeniu)
+    bool attachScratch(ScratchArena& arena, int numSamples, int controlStart = 0) noexcept;
+    const float* getEnvelopeBlock(int index) const { return stage[env1Channel + index]; }
+    // przy 1x operatory pisza od razu do wyjscia glosu
+    float* getOperatorOutputBlock()
+    {
+        return oversampler.getFactor() > 1 ? stage[oversampledChannel] : stage[outputChannel];
+    }
+
+    // glosy o tym samym kluczu moga byc liczone razem
+    int getRoutingKey() const noexcept;
+    bool canRenderPacked() const noexcept { return isVoiceActive() && stealFadeRemaining == 0 && pendingNote < 0; }
 
-    juce::AudioBuffer<float> synthBuffer;
+    // presety bez sprzezenia - specjalizowane wersje, ze sprzezeniem - harmonogram skompilowany w setAlgorithm
+    template <typename Operators>
+    void processRouting(Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples) const
+    {
+        // operatory bez wkladu w tym bloku tylko przesuwaja faze
+        operators.prunedOperators = FMAlgorithmRouter::findPrunedOperators(routingMatrix, operators, blocks, numSamples);
+
+        if (useRoutingSchedule)
+            routingSchedule.process(operators, blocks, output, numSamples);
+        else
+            FMAlgorithmRouter::processBlock(currentAlgorithm, operators, blocks, output, numSamples);
+    }
+
+    // tablice etapow: obwiednie, wyjscia operatorow, suma modulacji i mono wyjscie glosu z areny watku
+    // (tylko na czas bloku), obwiednia filtra i odciecie w controlBuffer - wspolny filtr czyta je po bloku
+    enum StageChannel
+    {
+        env1Channel = 0, env2Channel, env3Channel, env4Channel,
+        out1Channel, out2Channel, out3Channel, out4Channel, modulationChannel, oversampledChannel,
+        outputChannel,
+        modEnvChannel, cutoffChannel,
+        numStageChannels
+    };
+    float* stage[numStageChannels] = {};
+    juce::AudioBuffer<float> controlBuffer;
+    int controlOffset{ 0 };                 // probki juz zapisane w controlBuffer w biezacym renderNextBlock
+    ScratchArena* scratch{ nullptr };       // arena watku, ktory liczy glos (ustawia FMSynthesiser)
+    int maxBlockSize{ 0 };
+
+    // wygaszanie ukradzionego glosu zeby nie klikal
+    static constexpr double stealFadeSeconds = 0.003;
+    int stealFadeLength{ 1 };
+    int stealFadeRemaining{ 0 };
+    int pendingNote{ -1 };
+    bool pendingNoteReleased{ false };
+    float envelopeLevel{ 0.0f };
+
+    // polaczenia algorytmu (ze sprzezeniem albo bez) - nosne decyduja o koncu nuty, modulatory o pomijaniu operatorow
+    RoutingMatrix routingMatrix = RoutingPresets::algorithms[0];
+    static constexpr double silenceHoldSeconds = 0.05;
+    float silenceThreshold{ 0.0f };
+    int silenceHoldLength{ 1 };
+    int silentSamples{ 0 };
+
+    // linki listy aktywnych/wolnych glosow
+    SynthVoice* prevInList{ nullptr };
+    SynthVoice* nextInList{ nullptr };
+    bool isInActiveList{ false };
+
+    // FMSynthesiser::onVoiceStart - parametry nuty wpisywane dopiero gdy nuta naprawde startuje
+    // (kradziony glos wygasza stara nute jeszcze z jej parametrami)
+    const std::function<void(SynthVoice&)>* onNoteBegin{ nullptr };
+
+    OversamplingData oversampler;           // decymacja wyjscia operatorow do outputChannel
+    int oversamplingMode{ OversamplingData::mode1x };
+    double currentSampleRate{ 48000.0 };
+    double envelopeRate{ 0.0 };             // czestotliwosc obwiedni operatorow (host * faktor)
+    juce::AudioBuffer<float> mixBuffer;     // miks glosu gdy liczony na watku pomocniczym
 
     OscData osc1, osc2, osc3, osc4; 
     float baseFrequency{ 0.0f };   
@@ -47,12 +179,21 @@ private:
     FilterData filter;
     AdsrData modAdsr;
     int currentFilterType{ 0 };      
-    float currentCutoff{ 500.0f };  
+    ParameterRamp cutoffRamp{ ParameterRamp::multiplicative, 500.0f };     // odciecie filtra, rowno w oktawach
     float currentResonance{ 1.0f };  
+    double rampSeconds{ 0.0 };
 
     juce::dsp::Gain<float> gain;
 
     int currentAlgorithm = 0;
+    float currentFeedback = 0.0f;
+    RoutingSchedule routingSchedule;
+    bool useRoutingSchedule{ false };
     bool filterEnabled{ true };
+    bool filterShared{ false };
     bool isPrepared{ false };
+
+    // wersje grup PatchSnapshot juz wpisane do glosu
+    juce::uint32 appliedRevisions[PatchSnapshot::numGroups] = {};
+    int numRecomputations{ 0 };
 };
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    AlgorithmBenchmark.cpp
+    Created: 17 Oct 2026 11:20:05pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// FMAlgorithmRouter: kernele generowane z RoutingPresets (tablica wskaznikow raz na blok)
+// kontra dawny router - switch po algorytmie i operatory po kolei calymi blokami
+// wszystkie 8 algorytmow, 4 ksztalty naiwne i z PolyBLEP, pojedynczy glos i grupa glosow (LaneOperators)
+//   AlgorithmBenchmark [liczba blokow]
+
+#include "Benchmarks/BenchmarkUtilities.h"
+#include "Data/FMAlgorithmRouter.h"
+#include <vector>
+
+namespace
+{
+    // router sprzed kerneli z tablicy - ten sam kod co wtedy, operatory przez Operators::process
+    template <typename Operators>
+    void processBlockSwitch(int algorithmIndex, Operators& operators, const OperatorBlocks& blocks, float* output, int numSamples)
+    {
+        const int numValues = numSamples * Operators::numLanes;
+        float* out1 = blocks.out[0];
+        float* out2 = blocks.out[1];
+        float* out3 = blocks.out[2];
+        float* out4 = blocks.out[3];
+        float* mod = blocks.modulation;
+
+        auto osc = [&](int index, const float* m, float* out) { operators.process(index, m, blocks.env[index], out, numSamples); };
+
+        switch (algorithmIndex)
+        {
+        case 0:
+            osc(3, nullptr, out4); osc(2, out4, out3); osc(1, out3, out2); osc(0, out2, output);
+            break;
+        case 1:
+            osc(3, nullptr, out4); osc(2, nullptr, out3);
+            for (int i = 0; i < numValues; ++i) mod[i] = out4[i] + out3[i];
+            osc(1, mod, out2); osc(0, out2, output);
+            break;
+        case 2:
+            osc(3, nullptr, out4); osc(2, out4, out3); osc(1, out4, out2);
+            for (int i = 0; i < numValues; ++i) mod[i] = out3[i] + out2[i];
+            osc(0, mod, output);
+            break;
+        case 3:
+            osc(3, nullptr, out4); osc(2, out4, out3); osc(1, out3, out2); osc(0, out3, out1);
+            for (int i = 0; i < numValues; ++i) output[i] = (out2[i] + out1[i]) * 0.5f;
+            break;
+        case 4:
+            osc(3, nullptr, out4); osc(2, nullptr, out3); osc(1, nullptr, out2);
+            for (int i = 0; i < numValues; ++i) mod[i] = out4[i] + out3[i] + out2[i];
+            osc(0, mod, output);
+            break;
+        case 5:
+            osc(3, nullptr, out4); osc(2, out4, out3); osc(1, out4, out2); osc(0, out4, out1);
+            for (int i = 0; i < numValues; ++i) output[i] = (out3[i] + out2[i] + out1[i]) / 3.0f;
+            break;
+        case 6:
+            osc(3, nullptr, out4); osc(2, nullptr, out3);
+            for (int i = 0; i < numValues; ++i) mod[i] = out4[i] + out3[i];
+            osc(1, mod, out2); osc(0, mod, out1);
+            for (int i = 0; i < numValues; ++i) output[i] = (out2[i] + out1[i]) * 0.5f;
+            break;
+        default:
+            osc(3, nullptr, out4); osc(2, nullptr, out3); osc(1, nullptr, out2); osc(0, nullptr, out1);
+            for (int i = 0; i < numValues; ++i) output[i] = (out4[i] + out3[i] + out2[i] + out1[i]) * 0.25f;
+            break;
+        }
+    }
+
+    // bufory jednego bloku [probka][glos]
+    struct Buffers
+    {
+        explicit Buffers(int numValues) : storage((size_t)(10 * numValues), 0.8f), size(numValues)
+        {
+            for (int op = 0; op < 4; ++op)
+            {
+                blocks.env[op] = channel(op);
+                blocks.out[op] = channel(4 + op);
+            }
+
+            blocks.modulation = channel(8);
+        }
+
+        float* channel(int index) { return storage.data() + (size_t)(index * size); }
+        float* output() { return channel(9); }
+
+        std::vector<float> storage;
+        int size;
+        OperatorBlocks blocks{};
+    };
+
+    struct Voice
+    {
+        Voice(int waveType, bool bandLimited, double sampleRate, int blockSize)
+        {
+            juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)blockSize, 1 };
+
+            for (int op = 0; op < 4; ++op)
+            {
+                osc[op].prepareToPlay(spec);
+                osc[op].setWaveType(waveType);
+                osc[op].setBandLimited(bandLimited);
+                osc[op].setPrecision(OperatorKernel::polynomialPrecision);
+                osc[op].setGain(0.5f);
+                osc[op].skipGainRamp();
+                osc[op].setBaseFreqParams(220.0f, (float)(op + 1), 0.0f);
+            }
+        }
+
+        VoiceOperators operators() { return { { &osc[0], &osc[1], &osc[2], &osc[3] } }; }
+
+        OscData osc[4];
+    };
+
+    LaneOperators makeLanes(const Voice& voice)
+    {
+        LaneOperators lanes;
+
+        for (int op = 0; op < 4; ++op)
+        {
+            lanes.waveType[op] = voice.osc[op].getKernelWave();
+            lanes.precision[op] = voice.osc[op].getPrecision();
+            lanes.modulationMode[op] = voice.osc[op].getModulationMode();
+            lanes.modulationScale[op] = voice.osc[op].getModulationScale();
+            lanes.dcBlockerCoefficient = voice.osc[op].getDcBlockerCoefficient();
+
+            // glosy grupy z roznymi wysokosciami
+            for (int lane = 0; lane < LaneOperators::numLanes; ++lane)
+            {
+                lanes.state[op].phaseIncrement[lane] = (juce::uint32)(voice.osc[op].getState().phaseIncrement[0] * (1.0 + 0.1 * lane));
+                lanes.state[op].gain[lane] = 0.5f;
+            }
+        }
+
+        return lanes;
+    }
+
+    // najwieksza roznica wyjsc obu routerow z tego samego stanu (jeden blok)
+    template <typename Operators>
+    float compareOutputs(int algorithm, const Operators& initial, int numSamples)
+    {
+        const int numValues = numSamples * Operators::numLanes;
+        Buffers a(numValues), b(numValues);
+        auto first = initial, second = initial;
+
+        FMAlgorithmRouter::processBlock(algorithm, first, a.blocks, a.output(), numSamples);
+        processBlockSwitch(algorithm, second, b.blocks, b.output(), numSamples);
+
+        float difference = 0.0f;
+        for (int i = 0; i < numValues; ++i)
+            difference = juce::jmax(difference, std::abs(a.output()[i] - b.output()[i]));
+        return difference;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+    const int numBlocks = Benchmark::getNumBlocks(argc, argv, 4000);
+    const char* waveNames[] = { "sine", "saw", "square", "triangle", "saw BL", "square BL", "triangle BL" };
+    constexpr int lanes = LaneOperators::numLanes;
+
+    std::printf("ns per voice-sample, %d blocks of %d samples, polynomial precision, %d lanes\n\n", numBlocks, blockSize, lanes);
+    std::printf("%-12s %-4s %10s %10s %8s %10s %10s %8s %10s\n",
+        "wave", "alg", "voice old", "voice new", "speedup", "lanes old", "lanes new", "speedup", "max diff");
+
+    for (int wave = 0; wave < OperatorKernel::numWaves; ++wave)
+    {
+        // ksztalt kernela -> wybor w OscData (sinus nie ma wersji z PolyBLEP)
+        const bool bandLimited = wave >= OperatorKernel::bandLimitedSawWave;
+        const int waveType = bandLimited ? wave - (OperatorKernel::bandLimitedSawWave - OperatorKernel::sawWave) : wave;
+
+        for (int algorithm = 0; algorithm < FMAlgorithmRouter::numAlgorithms; ++algorithm)
+        {
+            Voice voice(waveType, bandLimited, sampleRate, blockSize);
+            auto voiceOperators = voice.operators();
+            auto laneOperators = makeLanes(voice);
+
+            const float difference = juce::jmax(compareOutputs(algorithm, voiceOperators, blockSize),
+                                                compareOutputs(algorithm, laneOperators, blockSize));
+
+            Buffers voiceBuffers(blockSize), laneBuffers(blockSize * lanes);
+
+            auto runVoice = [&](auto&& router)
+            {
+                return Benchmark::measureSeconds([&]
+                {
+                    for (int block = 0; block < numBlocks; ++block)
+                    {
+                        router(voiceOperators, voiceBuffers);
+                        for (auto* osc : voiceOperators.osc)
+                            osc->advancePhaseFraction(blockSize);
+                    }
+                    Benchmark::consume(voiceBuffers.output(), blockSize);
+                }) * 1.0e9 / ((double)numBlocks * blockSize);
+            };
+
+            auto runLanes = [&](auto&& router)
+            {
+                return Benchmark::measureSeconds([&]
+                {
+                    for (int block = 0; block < numBlocks; ++block)
+                        router(laneOperators, laneBuffers);
+                    Benchmark::consume(laneBuffers.output(), blockSize * lanes);
+                }) * 1.0e9 / ((double)numBlocks * blockSize * lanes);
+            };
+
+            auto specialised = [&](auto& operators, Buffers& buffers)
+            {
+                FMAlgorithmRouter::processBlock(algorithm, operators, buffers.blocks, buffers.output(), blockSize);
+            };
+
+            auto legacy = [&](auto& operators, Buffers& buffers)
+            {
+                processBlockSwitch(algorithm, operators, buffers.blocks, buffers.output(), blockSize);
+            };
+
+            const double voiceOld = runVoice(legacy);
+            const double voiceNew = runVoice(specialised);
+            const double lanesOld = runLanes(legacy);
+            const double lanesNew = runLanes(specialised);
+
+            std::printf("%-12s %-4d %10.2f %10.2f %7.2fx %10.2f %10.2f %7.2fx %10.1e\n",
+                waveNames[wave], algorithm + 1, voiceOld, voiceNew, voiceOld / voiceNew,
+                lanesOld, lanesNew, lanesOld / lanesNew, difference);
+        }
+    }
+
+    return 0;
+}
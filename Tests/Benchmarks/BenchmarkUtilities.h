@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    BenchmarkUtilities.h
+    Created: 17 Oct 2026 11:20:05pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <chrono>
+#include <cstdio>
+
+namespace Benchmark
+{
+    // najlepszy z kilku pomiarow - pojedynczy bywa zaklocony przez inne procesy
+    template <typename Function>
+    double measureSeconds(Function&& function, int repeats = 5)
+    {
+        double best = 1.0e30;
+
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const auto end = std::chrono::steady_clock::now();
+            best = juce::jmin(best, std::chrono::duration<double>(end - start).count());
+        }
+
+        return best;
+    }
+
+    // wynik, ktorego kompilator nie moze wyrzucic
+    inline volatile float sink = 0.0f;
+
+    inline void consume(const float* data, int numValues)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < numValues; ++i)
+            sum += data[i];
+        sink = sink + sum;
+    }
+
+    // liczba blokow z linii polecen (szybki przebieg: mniej)
+    inline int getNumBlocks(int argc, char** argv, int defaultBlocks)
+    {
+        return argc > 1 ? juce::jmax(1, std::atoi(argv[1])) : defaultBlocks;
+    }
+}
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    ModulationModeBenchmark.cpp
+    Created: 18 Oct 2026 12:31:17am
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// koszt MODMODE: modulacja fazy (PM) kontra czestotliwosci (FM, z DC-blokerem)
+// cztery operatory przez FMAlgorithmRouter: algorytm 1 (lancuch) i 7 (dwa modulatory na dwie nosne),
+// sinus i pila, kazda dokladnosc, pojedynczy glos i grupa glosow
+//   ModulationModeBenchmark [liczba blokow]
+
+#include "Benchmarks/BenchmarkUtilities.h"
+#include "Data/FMAlgorithmRouter.h"
+#include <vector>
+
+namespace
+{
+    struct Buffers
+    {
+        explicit Buffers(int numValues) : storage((size_t)(10 * numValues), 0.8f), size(numValues)
+        {
+            for (int op = 0; op < 4; ++op)
+            {
+                blocks.env[op] = channel(op);
+                blocks.out[op] = channel(4 + op);
+            }
+
+            blocks.modulation = channel(8);
+        }
+
+        float* channel(int index) { return storage.data() + (size_t)(index * size); }
+        float* output() { return channel(9); }
+
+        std::vector<float> storage;
+        int size;
+        OperatorBlocks blocks{};
+    };
+
+    struct Voice
+    {
+        Voice(int waveType, int precision, int mode, double sampleRate, int blockSize)
+        {
+            juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)blockSize, 1 };
+
+            for (int op = 0; op < 4; ++op)
+            {
+                osc[op].prepareToPlay(spec);
+                osc[op].setWaveType(waveType);
+                osc[op].setPrecision(precision);
+                osc[op].setModulationMode(mode);
+                osc[op].setModulationIndex(2.0f);
+                osc[op].setGain(0.5f);
+                osc[op].skipGainRamp();
+                osc[op].setBaseFreqParams(220.0f, (float)(op + 1), 0.0f);
+            }
+        }
+
+        VoiceOperators operators() { return { { &osc[0], &osc[1], &osc[2], &osc[3] } }; }
+
+        OscData osc[4];
+    };
+
+    LaneOperators makeLanes(const Voice& voice)
+    {
+        LaneOperators lanes;
+
+        for (int op = 0; op < 4; ++op)
+        {
+            lanes.waveType[op] = voice.osc[op].getKernelWave();
+            lanes.precision[op] = voice.osc[op].getPrecision();
+            lanes.modulationMode[op] = voice.osc[op].getModulationMode();
+            lanes.modulationScale[op] = voice.osc[op].getModulationScale();
+            lanes.dcBlockerCoefficient = voice.osc[op].getDcBlockerCoefficient();
+
+            for (int lane = 0; lane < LaneOperators::numLanes; ++lane)
+            {
+                lanes.state[op].phaseIncrement[lane] = (juce::uint32)(voice.osc[op].getState().phaseIncrement[0] * (1.0 + 0.1 * lane));
+                lanes.state[op].gain[lane] = 0.5f;
+            }
+        }
+
+        return lanes;
+    }
+
+    // ns na probke glosu: [0] pojedynczy glos, [1] grupa glosow
+    struct Result { double voice, lanes; };
+
+    Result measure(int algorithm, int waveType, int precision, int mode, int numBlocks, int blockSize)
+    {
+        constexpr int lanes = LaneOperators::numLanes;
+        Voice voice(waveType, precision, mode, 48000.0, blockSize);
+        auto voiceOperators = voice.operators();
+        auto laneOperators = makeLanes(voice);
+        Buffers voiceBuffers(blockSize), laneBuffers(blockSize * lanes);
+
+        const double voiceSeconds = Benchmark::measureSeconds([&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                FMAlgorithmRouter::processBlock(algorithm, voiceOperators, voiceBuffers.blocks, voiceBuffers.output(), blockSize);
+                for (auto* osc : voiceOperators.osc)
+                    osc->advancePhaseFraction(blockSize);
+            }
+            Benchmark::consume(voiceBuffers.output(), blockSize);
+        });
+
+        const double laneSeconds = Benchmark::measureSeconds([&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+                FMAlgorithmRouter::processBlock(algorithm, laneOperators, laneBuffers.blocks, laneBuffers.output(), blockSize);
+            Benchmark::consume(laneBuffers.output(), blockSize * lanes);
+        });
+
+        return { voiceSeconds * 1.0e9 / ((double)numBlocks * blockSize),
+                 laneSeconds * 1.0e9 / ((double)numBlocks * blockSize * lanes) };
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int blockSize = 256;
+    const int numBlocks = Benchmark::getNumBlocks(argc, argv, 4000);
+    const int algorithms[] = { 0, 6 };
+    const int waveTypes[] = { 0, 1 };
+    const char* waveNames[] = { "sine", "saw" };
+    const char* precisionNames[] = { "exact", "polynomial", "table" };
+
+    std::printf("ns per voice-sample (4 operators), %d blocks of %d samples\n\n", numBlocks, blockSize);
+    std::printf("%-4s %-6s %-12s %10s %10s %8s %10s %10s %8s\n",
+        "alg", "wave", "precision", "voice FM", "voice PM", "PM/FM", "lanes FM", "lanes PM", "PM/FM");
+
+    for (int algorithm : algorithms)
+    {
+        for (int wave = 0; wave < 2; ++wave)
+        {
+            for (int precision = 0; precision < OperatorKernel::numPrecisions; ++precision)
+            {
+                const auto fm = measure(algorithm, waveTypes[wave], precision, OperatorKernel::frequencyModulation, numBlocks, blockSize);
+                const auto pm = measure(algorithm, waveTypes[wave], precision, OperatorKernel::phaseModulation, numBlocks, blockSize);
+
+                std::printf("%-4d %-6s %-12s %10.2f %10.2f %7.2fx %10.2f %10.2f %7.2fx\n",
+                    algorithm + 1, waveNames[wave], precisionNames[precision],
+                    fm.voice, pm.voice, pm.voice / fm.voice, fm.lanes, pm.lanes, pm.lanes / fm.lanes);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    PrecisionBenchmark.cpp
+    Created: 17 Oct 2026 11:48:31pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// przepustowosc OperatorKernel::process dla kazdej dokladnosci (OperatorKernel::Precision)
+// jeden operator z modulacja FM, pojedynczy glos i grupa glosow, 4 naiwne ksztalty
+//   PrecisionBenchmark [liczba blokow]
+
+#include "Benchmarks/BenchmarkUtilities.h"
+#include "Data/OperatorKernel.h"
+#include <vector>
+
+namespace
+{
+    template <int Lanes>
+    double measureOperator(int wave, int precision, int numBlocks, int blockSize)
+    {
+        const int numValues = blockSize * Lanes;
+        std::vector<float> modulation((size_t)numValues), env((size_t)numValues, 0.8f), output((size_t)numValues);
+
+        for (int i = 0; i < numValues; ++i)
+            modulation[(size_t)i] = 0.5f * std::sin(0.01f * (float)i);
+
+        OperatorState<Lanes> state;
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            state.phaseIncrement[lane] = (juce::uint32)(4294967296.0 * (220.0 + 37.0 * lane) / 48000.0);
+            state.gain[lane] = 0.5f;
+        }
+
+        const double seconds = Benchmark::measureSeconds([&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+                OperatorKernel::process<Lanes>(state, wave, precision, OperatorKernel::frequencyModulation, 0.995f, 0.05f,
+                    modulation.data(), env.data(), output.data(), blockSize);
+            Benchmark::consume(output.data(), numValues);
+        });
+
+        return seconds * 1.0e9 / ((double)numBlocks * numValues);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int blockSize = 256;
+    const int numBlocks = Benchmark::getNumBlocks(argc, argv, 20000);
+    const char* waveNames[] = { "sine", "saw", "square", "triangle" };
+    const char* precisionNames[] = { "exact", "polynomial", "table" };
+
+    std::printf("ns per operator-sample, %d blocks of %d samples, FM\n\n", numBlocks, blockSize);
+    std::printf("%-10s %-12s %10s %10s\n", "wave", "precision", "voice", "lanes");
+
+    for (int wave = 0; wave < 4; ++wave)
+        for (int precision = 0; precision < OperatorKernel::numPrecisions; ++precision)
+            std::printf("%-10s %-12s %10.2f %10.2f\n", waveNames[wave], precisionNames[precision],
+                measureOperator<1>(wave, precision, numBlocks, blockSize),
+                measureOperator<OperatorKernel::numLanes>(wave, precision, numBlocks, blockSize));
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    WaveQualityBenchmark.cpp
+    Created: 18 Oct 2026 12:09:40am
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// koszt WAVEQUALITY: pila/kwadrat/trojkat naiwne kontra z korekcja PolyBLEP/PolyBLAMP
+// jeden operator z modulacja FM, pojedynczy glos i grupa glosow, kazda dokladnosc
+//   WaveQualityBenchmark [liczba blokow]
+
+#include "Benchmarks/BenchmarkUtilities.h"
+#include "Data/OperatorKernel.h"
+#include <vector>
+
+namespace
+{
+    template <int Lanes>
+    double measureOperator(int wave, int precision, int numBlocks, int blockSize)
+    {
+        const int numValues = blockSize * Lanes;
+        std::vector<float> modulation((size_t)numValues), env((size_t)numValues, 0.8f), output((size_t)numValues);
+
+        for (int i = 0; i < numValues; ++i)
+            modulation[(size_t)i] = 0.5f * std::sin(0.01f * (float)i);
+
+        // wysoka nuta - korekcja przy skoku liczona czesto
+        OperatorState<Lanes> state;
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            state.phaseIncrement[lane] = (juce::uint32)(4294967296.0 * (1760.0 + 110.0 * lane) / 48000.0);
+            state.gain[lane] = 0.5f;
+        }
+
+        const double seconds = Benchmark::measureSeconds([&]
+        {
+            for (int block = 0; block < numBlocks; ++block)
+                OperatorKernel::process<Lanes>(state, wave, precision, OperatorKernel::frequencyModulation, 0.995f, 0.05f,
+                    modulation.data(), env.data(), output.data(), blockSize);
+            Benchmark::consume(output.data(), numValues);
+        });
+
+        return seconds * 1.0e9 / ((double)numBlocks * numValues);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int blockSize = 256;
+    const int numBlocks = Benchmark::getNumBlocks(argc, argv, 20000);
+    const char* waveNames[] = { "saw", "square", "triangle" };
+    const char* precisionNames[] = { "exact", "polynomial", "table" };
+    constexpr int lanes = OperatorKernel::numLanes;
+
+    std::printf("ns per operator-sample, %d blocks of %d samples, FM\n\n", numBlocks, blockSize);
+    std::printf("%-10s %-12s %10s %10s %8s %10s %10s %8s\n",
+        "wave", "precision", "voice", "voice BL", "cost", "lanes", "lanes BL", "cost");
+
+    for (int wave = OperatorKernel::sawWave; wave <= OperatorKernel::triangleWave; ++wave)
+    {
+        const int bandLimitedWave = OperatorKernel::getWave(wave, true);
+
+        for (int precision = 0; precision < OperatorKernel::numPrecisions; ++precision)
+        {
+            const double voice = measureOperator<1>(wave, precision, numBlocks, blockSize);
+            const double voiceBandLimited = measureOperator<1>(bandLimitedWave, precision, numBlocks, blockSize);
+            const double laneGroup = measureOperator<lanes>(wave, precision, numBlocks, blockSize);
+            const double laneGroupBandLimited = measureOperator<lanes>(bandLimitedWave, precision, numBlocks, blockSize);
+
+            std::printf("%-10s %-12s %10.2f %10.2f %7.2fx %10.2f %10.2f %7.2fx\n",
+                waveNames[wave - OperatorKernel::sawWave], precisionNames[precision],
+                voice, voiceBandLimited, voiceBandLimited / voice,
+                laneGroup, laneGroupBandLimited, laneGroupBandLimited / laneGroup);
+        }
+    }
+
+    return 0;
+}
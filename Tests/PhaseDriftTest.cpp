@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    PhaseDriftTest.cpp
+    Created: 17 Oct 2026 11:58:12pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// faza OscData po 10 minutach przy 192 kHz wzgledem idealnej fazy liczonej w long double
+// licznik fazy + reszta przyrostu (advancePhaseFraction) nie moga odplynac od czestotliwosci
+
+#include <JuceHeader.h>
+#include "Data/OscData.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 192000.0;
+    constexpr double durationSeconds = 600.0;
+    constexpr int blockSize = 512;
+
+    // rozdzielczosc fazy w radianach jako float to ok. 3.7e-7, bez reszty przyrostu blad dochodzi do 3e-3..1e-1
+    constexpr double maxAllowedError = 1.0e-5;
+
+    // najwiekszy blad fazy (rad) na granicach blokow
+    double measureDrift(double frequency)
+    {
+        OscData osc;
+        juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)blockSize, 1 };
+        osc.prepareToPlay(spec);
+        osc.setBaseFreqParams((float)frequency, 1.0f, 0.0f);
+
+        // czestotliwosc po przejsciu przez float jak w OscData
+        const long double exactFrequency = (long double)(float)frequency;
+        const long long totalSamples = (long long)(sampleRate * durationSeconds);
+        std::vector<float> env((size_t)blockSize, 1.0f), output((size_t)blockSize);
+        double maxError = 0.0;
+
+        for (long long done = blockSize; done <= totalSamples; done += blockSize)
+        {
+            osc.processBlock(nullptr, env.data(), output.data(), blockSize);
+            osc.advancePhaseFraction(blockSize);
+
+            long double cycles = exactFrequency * (long double)done / (long double)sampleRate;
+            cycles -= std::floor(cycles);
+
+            const double ideal = (double)(cycles * 2.0L * 3.14159265358979323846L);
+            const double error = std::abs((double)osc.getPhase() - ideal);
+            maxError = juce::jmax(maxError, juce::jmin(error, juce::MathConstants<double>::twoPi - error));
+        }
+
+        return maxError;
+    }
+}
+
+int main()
+{
+    const double frequencies[] = { 27.5, 440.0, 1234.567, 8372.018, 15000.3 };
+    int failures = 0;
+
+    for (double frequency : frequencies)
+    {
+        const double error = measureDrift(frequency);
+        const bool passed = error <= maxAllowedError;
+        failures += passed ? 0 : 1;
+
+        std::printf("%10.3f Hz  max phase error %.2e rad  %s\n", frequency, error, passed ? "ok" : "FAILED");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
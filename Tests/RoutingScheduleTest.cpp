@@ -0,0 +1,314 @@
+/*
+  ==============================================================================
+
+    RoutingScheduleTest.cpp
+    Created: 17 Oct 2026 11:41:27pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// RoutingSchedule::compile/process kontra naiwna referencja liczona probka po probce
+// losowe macierze 1-4 operatorow (tyle ma glos) z modulacja i sprzezeniami, presety z DX7-owym sprzezeniem,
+// pojedynczy glos (VoiceOperators) i grupa glosow (LaneOperators), bloki roznej dlugosci
+
+#include <JuceHeader.h>
+#include "Data/FMAlgorithmRouter.h"
+#include "Data/RoutingSchedule.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int maxBlockSize = 256;
+    constexpr int numBlocks = 6;
+    constexpr int numMatrices = 3000;
+    constexpr int numOperators = VoiceOperators::numOperators;
+    constexpr int lanes = LaneOperators::numLanes;
+
+    // pojedynczy glos liczy sie tak samo co do bitu, grupa glosow przez tick() zamiast process() moze roznic sie o zaokraglenie
+    constexpr float maxVoiceError = 0.0f;
+    constexpr float maxLaneError = 1.0e-5f;
+
+    bool hasOperator(int mask, int op) { return ((mask >> op) & 1) != 0; }
+
+    // dowolne polaczenia bez petli w tej samej probce (krawedzie zgodne z losowa kolejnoscia) i dowolne sprzezenia
+    RoutingMatrix makeRandomMatrix(std::mt19937& random)
+    {
+        RoutingMatrix matrix{};
+        const int n = 1 + (int)(random() % numOperators);
+        matrix.numOperators = n;
+
+        int order[numOperators] = { 0, 1, 2, 3 };
+        std::shuffle(order, order + n, random);
+
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+                if (random() % 3 == 0)
+                    matrix.modulators[order[a]] |= 1 << order[b];
+
+        for (int a = 0; a < n; ++a)
+            for (int b = 0; b < n; ++b)
+                if (random() % 5 == 0)
+                    matrix.feedback[a] |= 1 << b;
+
+        matrix.carriers = (int)(random() % (1u << n));
+        matrix.feedbackAmount = (float)(random() % 100) / 40.0f;
+        return matrix;
+    }
+
+    void setupOperators(OscData* osc, std::mt19937& random)
+    {
+        juce::dsp::ProcessSpec spec{ sampleRate, (juce::uint32)maxBlockSize, 1 };
+        const bool phaseModulation = random() % 2 == 0;
+
+        for (int op = 0; op < numOperators; ++op)
+        {
+            osc[op].prepareToPlay(spec);
+            osc[op].setWaveType((int)(random() % 4));
+            osc[op].setBandLimited(random() % 2 == 0);
+            osc[op].setPrecision((int)(random() % OperatorKernel::numPrecisions));
+            osc[op].setGain(0.2f + 0.1f * (float)(random() % 8));
+            osc[op].skipGainRamp();
+            osc[op].applyGainRamp(nullptr, 0);
+
+            if (phaseModulation)
+            {
+                osc[op].setModulationMode(OperatorKernel::phaseModulation);
+                osc[op].setModulationIndex(0.3f);
+            }
+
+            osc[op].setBaseFreqParams(110.0f + (float)(random() % 400), 1.0f + 0.5f * (float)(random() % 4), (float)(random() % 10));
+        }
+    }
+
+    // glosy grupy z roznymi wysokosciami i glosnosciami
+    LaneOperators makeLanes(const OscData* osc)
+    {
+        LaneOperators operators;
+
+        for (int op = 0; op < numOperators; ++op)
+        {
+            operators.waveType[op] = osc[op].getKernelWave();
+            operators.precision[op] = osc[op].getPrecision();
+            operators.modulationMode[op] = osc[op].getModulationMode();
+            operators.modulationScale[op] = osc[op].getModulationScale();
+            operators.dcBlockerCoefficient = osc[op].getDcBlockerCoefficient();
+
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                operators.state[op].phaseIncrement[lane] = (juce::uint32)(osc[op].getState().phaseIncrement[0] * (1.0 + 0.1 * lane));
+                operators.state[op].gain[lane] = osc[op].getState().gain[0] * (1.0f - 0.1f * (float)lane);
+            }
+        }
+
+        return operators;
+    }
+
+    // bufory [probka][glos] dla harmonogramu
+    struct Buffers
+    {
+        explicit Buffers(int numLanes) : storage((size_t)(10 * maxBlockSize * numLanes)), size(maxBlockSize * numLanes)
+        {
+            for (int op = 0; op < numOperators; ++op)
+            {
+                blocks.env[op] = channel(op);
+                blocks.out[op] = channel(4 + op);
+            }
+
+            blocks.modulation = channel(8);
+        }
+
+        float* channel(int index) { return storage.data() + (size_t)(index * size); }
+        float* output() { return channel(9); }
+
+        std::vector<float> storage;
+        int size;
+        OperatorBlocks blocks{};
+    };
+
+    // kolejnosc w referencji: dowolna topologiczna, modulatory tej samej probki przed odbiorca
+    void makeReferenceOrder(const RoutingMatrix& matrix, int* order)
+    {
+        const int n = matrix.numOperators;
+        int done = 0, count = 0;
+
+        while (count < n)
+        {
+            for (int op = 0; op < n; ++op)
+            {
+                if (!hasOperator(done, op) && (matrix.modulators[op] & ~done & ((1 << n) - 1)) == 0)
+                {
+                    order[count++] = op;
+                    done |= 1 << op;
+                    break;
+                }
+            }
+        }
+    }
+
+    // jedna probka wszystkich operatorow w tej samej kolejnosci dodawania co RoutingSchedule:
+    // modulatory od najwyzszego, potem sprzezenia od najwyzszego, sprzezenie na siebie ostatnie
+    template <typename Operators>
+    void referenceSample(const RoutingMatrix& matrix, const int* order, Operators& operators, const float* env,
+        float* current, float* previous, float* output)
+    {
+        constexpr int numLanes = Operators::numLanes;
+        const int n = matrix.numOperators;
+
+        for (int q = 0; q < n; ++q)
+        {
+            const int op = order[q];
+            float modulation[numLanes] = {};
+            bool any = false;
+
+            auto add = [&](const float* values, float amount, bool isFeedback)
+            {
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    const float value = isFeedback ? amount * values[lane] : values[lane];
+                    modulation[lane] = any ? modulation[lane] + value : value;
+                }
+
+                any = true;
+            };
+
+            for (int source = n - 1; source >= 0; --source)
+                if (hasOperator(matrix.modulators[op], source))
+                    add(current + source * numLanes, 1.0f, false);
+
+            for (int source = n - 1; source >= 0; --source)
+                if (source != op && hasOperator(matrix.feedback[op], source))
+                    add(previous + source * numLanes, matrix.feedbackAmount, true);
+
+            if (hasOperator(matrix.feedback[op], op))
+                add(previous + op * numLanes, matrix.feedbackAmount, true);
+
+            operators.process(op, any ? modulation : nullptr, env + op * numLanes, current + op * numLanes, 1);
+        }
+
+        int numCarriers = 0;
+        for (int lane = 0; lane < numLanes; ++lane)
+            output[lane] = 0.0f;
+
+        for (int op = n - 1; op >= 0; --op)
+        {
+            if (hasOperator(matrix.carriers, op))
+            {
+                for (int lane = 0; lane < numLanes; ++lane)
+                    output[lane] = numCarriers > 0 ? output[lane] + current[op * numLanes + lane] : current[op * numLanes + lane];
+                ++numCarriers;
+            }
+        }
+
+        if (numCarriers > 1)
+            for (int lane = 0; lane < numLanes; ++lane)
+                output[lane] = Operators::exact ? output[lane] / (float)numCarriers : output[lane] * (1.0f / (float)numCarriers);
+
+        for (int i = 0; i < n * numLanes; ++i)
+            previous[i] = current[i];
+    }
+
+    // najwieksza roznica harmonogramu i referencji po kilku blokach
+    template <typename Operators>
+    float compare(const RoutingMatrix& matrix, const RoutingSchedule& schedule, Operators scheduled, Operators reference)
+    {
+        constexpr int numLanes = Operators::numLanes;
+        Buffers buffers(numLanes);
+        int order[numOperators];
+        makeReferenceOrder(matrix, order);
+
+        float current[numOperators * numLanes] = {}, previous[numOperators * numLanes] = {};
+        float env[numOperators * numLanes], expected[numLanes];
+        float difference = 0.0f;
+        int time = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const int numSamples = (block * 97) % maxBlockSize + 1;
+
+            // obwiednie rozne dla operatorow i glosow, ciagle miedzy blokami
+            for (int i = 0; i < numSamples; ++i)
+                for (int op = 0; op < numOperators; ++op)
+                    for (int lane = 0; lane < numLanes; ++lane)
+                        buffers.channel(op)[i * numLanes + lane]
+                            = 0.3f + 0.7f * (float)std::pow(std::sin(0.01 * (time + i) * (op + 1) + lane), 2.0);
+
+            schedule.process(scheduled, buffers.blocks, buffers.output(), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int op = 0; op < numOperators; ++op)
+                    for (int lane = 0; lane < numLanes; ++lane)
+                        env[op * numLanes + lane] = buffers.blocks.env[op][i * numLanes + lane];
+
+                referenceSample(matrix, order, reference, env, current, previous, expected);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                    difference = juce::jmax(difference, std::abs(expected[lane] - buffers.output()[i * numLanes + lane]));
+            }
+
+            time += numSamples;
+        }
+
+        return difference;
+    }
+}
+
+int main()
+{
+    std::mt19937 random(1);
+    int failures = 0, withFeedback = 0, withLoops = 0;
+    float worstVoice = 0.0f, worstLanes = 0.0f;
+
+    for (int t = 0; t < numMatrices; ++t)
+    {
+        // najpierw presety z osc4 modulujacym sam siebie
+        const auto matrix = t < RoutingPresets::numAlgorithms ? RoutingPresets::withFeedback(t, 1.5f)
+                                                              : makeRandomMatrix(random);
+
+        RoutingSchedule schedule;
+        if (!schedule.compile(matrix))
+        {
+            std::printf("matrix %d: compile failed\n", t);
+            ++failures;
+            continue;
+        }
+
+        OscData scheduledOsc[numOperators], referenceOsc[numOperators];
+        const auto seed = random();
+        std::mt19937 setupA(seed), setupB(seed);
+        setupOperators(scheduledOsc, setupA);
+        setupOperators(referenceOsc, setupB);
+
+        const VoiceOperators scheduledVoice{ { &scheduledOsc[0], &scheduledOsc[1], &scheduledOsc[2], &scheduledOsc[3] } };
+        const VoiceOperators referenceVoice{ { &referenceOsc[0], &referenceOsc[1], &referenceOsc[2], &referenceOsc[3] } };
+        const float voiceError = compare(matrix, schedule, scheduledVoice, referenceVoice);
+
+        const auto laneOperators = makeLanes(scheduledOsc);
+        const float laneError = compare(matrix, schedule, laneOperators, laneOperators);
+
+        worstVoice = juce::jmax(worstVoice, voiceError);
+        worstLanes = juce::jmax(worstLanes, laneError);
+        withFeedback += schedule.hasFeedback() ? 1 : 0;
+
+        // petla kilku operatorow = dwa operatory osiagalne nawzajem przez sprzezenia
+        for (int op = 0; op < matrix.numOperators; ++op)
+            withLoops += (matrix.feedback[op] & ~(1 << op)) != 0 ? 1 : 0;
+
+        if (voiceError > maxVoiceError || laneError > maxLaneError)
+        {
+            if (++failures <= 10)
+                std::printf("matrix %d (%d operators): voice error %g, lane error %g  FAILED\n",
+                    t, matrix.numOperators, voiceError, laneError);
+        }
+    }
+
+    std::printf("%d matrices, %d with feedback, %d cross-operator feedback paths\n", numMatrices, withFeedback, withLoops);
+    std::printf("max error: voice %.3g, lanes %.3g  %s\n", worstVoice, worstLanes, failures == 0 ? "ok" : "FAILED");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    VoiceWorkerPoolTest.cpp
+    Created: 17 Oct 2026 11:36:52pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+// VoiceWorkerPool pod obciazeniem: kazde zadanie dokladnie raz w kazdym run(), tylko dozwoleni pomocnicy,
+// wynik niezalezny od liczby watkow; przerwy dluzsze niz dwa bloki usypiaja pomocnikow (budzenie),
+// prepare() z nowym czasem bloku w trakcie restartuje pomocnikow
+
+#include <JuceHeader.h>
+#include "VoiceWorkerPool.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    constexpr int numRuns = 20000;
+    constexpr int numWorkers = 3;
+    constexpr int maxTasksPerRun = 40;
+
+    struct Context
+    {
+        std::atomic<int> hits[maxTasksPerRun];
+        std::atomic<int> wrongThread{ 0 };
+        std::atomic<int> byHelpers{ 0 };
+        int maxThreadIndex = 0;
+        float results[maxTasksPerRun] = {};
+    };
+
+    // troche pracy, wynik zalezny tylko od numeru zadania
+    float computeTask(int taskIndex)
+    {
+        float value = (float)taskIndex;
+        for (int i = 0; i < 200; ++i)
+            value = value * 0.999f + 0.001f * (float)i;
+        return value;
+    }
+
+    void runTask(void* context, int taskIndex, int threadIndex)
+    {
+        auto& c = *static_cast<Context*>(context);
+
+        c.hits[taskIndex].fetch_add(1, std::memory_order_relaxed);
+        c.results[taskIndex] = computeTask(taskIndex);
+
+        if (threadIndex > c.maxThreadIndex)
+            c.wrongThread.fetch_add(1, std::memory_order_relaxed);
+        if (threadIndex > 0)
+            c.byHelpers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int main()
+{
+    VoiceWorkerPool pool;
+    pool.prepare(numWorkers, 48000.0, 256);
+
+    Context context;
+    long wrongCounts = 0, wrongResults = 0;
+
+    for (int r = 0; r < numRuns; ++r)
+    {
+        const int numTasks = 1 + r % maxTasksPerRun;
+        const int workersToUse = r % (numWorkers + 1);
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            context.hits[i].store(0, std::memory_order_relaxed);
+            context.results[i] = 0.0f;
+        }
+
+        context.maxThreadIndex = workersToUse;
+        pool.run(numTasks, workersToUse, runTask, &context);
+
+        for (int i = 0; i < numTasks; ++i)
+        {
+            wrongCounts += context.hits[i].load(std::memory_order_relaxed) != 1 ? 1 : 0;
+            wrongResults += context.results[i] != computeTask(i) ? 1 : 0;
+        }
+
+        // transport stoi - pomocnicy zasypiaja, nastepny run() musi ich obudzic
+        if (r % 5000 == 4999)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // ten sam THREADS, inny czas bloku (i to samo jeszcze raz) w trakcie grania
+        if (r == numRuns / 2)
+        {
+            pool.prepare(numWorkers, 44100.0, 512);
+            pool.prepare(numWorkers, 44100.0, 512);
+        }
+    }
+
+    const int workersAfterRun = pool.getNumWorkers();
+    pool.release();
+
+    const bool passed = wrongCounts == 0 && wrongResults == 0 && context.wrongThread.load() == 0 && workersAfterRun == numWorkers;
+
+    std::printf("%d runs: %ld tasks not run exactly once, %ld wrong results, %d on disallowed threads, %d run by helpers  %s\n",
+        numRuns, wrongCounts, wrongResults, context.wrongThread.load(), context.byHelpers.load(), passed ? "ok" : "FAILED");
+
+    return passed ? 0 : 1;
+}
@@ -22,6 +22,10 @@ AdsrComponent::AdsrComponent(juce::String name, juce::AudioProcessorValueTreeSta
     setSliderWithLabel(decaySlider, decayLabel, apvts, decayId, decayAttachment);
     setSliderWithLabel(sustainSlider, sustainLabel, apvts, sustainId, sustainAttachment);
     setSliderWithLabel(releaseSlider, releaseLabel, apvts, releaseId, releaseAttachment);
+
+    // tlo, ramka i napisy sie nie zmieniaja - panel z pamieci, odrysowywane tylko poruszone kontrolki
+    setOpaque(true);
+    setBufferedToImage(true);
 }
 
 AdsrComponent::~AdsrComponent()
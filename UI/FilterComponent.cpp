@@ -30,8 +30,16 @@ FilterComponent::FilterComponent(juce::AudioProcessorValueTreeState& apvts, juce
         apvts, "FILTERON", filterOnToggle);
     addAndMakeVisible(filterOnToggle);
 
+    paraphonicAttach = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        apvts, "FILTERPARA", paraphonicToggle);
+    addAndMakeVisible(paraphonicToggle);
+
     setSliderWithLabel(filterFreqSlider, filterFreqLabel, apvts, filterFreqId, filterFreqAttachment);
     setSliderWithLabel(filterResSlider, filterResLabel, apvts, filterResId, filterResAttachment);
+
+    // tlo, ramka i napisy sie nie zmieniaja - panel z pamieci, odrysowywane tylko poruszone kontrolki
+    setOpaque(true);
+    setBufferedToImage(true);
 }
 
 FilterComponent::~FilterComponent()
@@ -70,6 +78,7 @@ void FilterComponent::resized()
     filterResLabel.setBounds(filterResSlider.getX(), filterResSlider.getY() - labelYOffset, filterResSlider.getWidth(), labelHeight);
 
     filterOnToggle.setBounds(7, 35, 100, 20);
+    paraphonicToggle.setBounds(filterOnToggle.getRight(), 35, 110, 20);
 
 }
 
@@ -42,6 +42,9 @@ private:
     juce::ToggleButton filterOnToggle{ "On/Off" };
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> filterOnAttach;
 
+    juce::ToggleButton paraphonicToggle{ "Paraphonic" };
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> paraphonicAttach;
+
 
     void setSliderWithLabel(juce::Slider& slider, juce::Label& label, 
         juce::AudioProcessorValueTreeState& apvts, juce::String paramId, 
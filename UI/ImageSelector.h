@@ -38,6 +38,9 @@ public:
             addAndMakeVisible(btn);
         }
         updateToggleStatesFromParam();
+
+        // tlo zamalowane w calosci - rodzic nie musi sie pod nim odrysowywac
+        setOpaque(true);
     }
 
     ~GenericImageSelector() override
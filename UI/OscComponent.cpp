@@ -49,6 +49,10 @@ OscComponent::OscComponent(juce::AudioProcessorValueTreeState& apvts,
     setSliderWithLabel(coarseSlider, coarseLabel, apvts, coarseId, coarseAttachment);
     setSliderWithLabel(fineSlider, fineLabel, apvts, fineId, fineAttachment);
     setSliderWithLabel(gainSlider, gainLabel, apvts, gainId, gainAttachment);
+
+    // tlo, ramka i napisy sie nie zmieniaja - panel z pamieci, odrysowywane tylko poruszone kontrolki
+    setOpaque(true);
+    setBufferedToImage(true);
 }
 
 OscComponent::~OscComponent()
@@ -12,59 +12,150 @@
 
 OscilloscopeComponent::OscilloscopeComponent()
 {
-    startTimerHz(30); // 30 razy na sek
+    setOpaque(true);
 }
 
 OscilloscopeComponent::~OscilloscopeComponent()
 {
-    stopTimer();
 }
 
-void OscilloscopeComponent::pushSamples(const float* samples, int numSamples)
+void OscilloscopeComponent::pushSamples(const float* newSamples, int numSamples, int numDisplaySamples)
 {
-    const juce::ScopedLock sl(bufferLock);
+    if (numSamples <= 0)
+        return;
+
     // zastap bufor nowymi probkami
-    circularBuffer.assign(samples, samples + numSamples);
-    // reset index
-    writeIndex = 0;
+    samples.assign(newSamples, newSamples + numSamples);
+
+    displaySamples = numDisplaySamples > 0 ? juce::jmin(numDisplaySamples, numSamples) : numSamples;
+    triggerPosition = findTrigger(displaySamples);
+    traceDirty = true;
 }
 
+float OscilloscopeComponent::findTrigger(int numDisplaySamples) const noexcept
+{
+    const int numSamples = static_cast<int>(samples.size());
+    const int lastStart = numSamples - numDisplaySamples;
 
+    // histereza - szum przy zerze nie przestawia wyzwalania
+    const float hysteresis = 0.01f;
 
-void OscilloscopeComponent::paint(juce::Graphics& g)
+    // jeden przebieg od poczatku: uzbrojony po zejsciu ponizej -histerezy, rozbrojony po wyjsciu ponad +histereze,
+    // zapamietane ostatnie uzbrojone zbocze narastajace, po ktorym miesci sie caly obraz
+    bool armed = false;
+    int trigger = -1;
+
+    for (int i = 1; i <= lastStart; ++i)
+    {
+        const float before = samples[(size_t)i - 1];
+        if (before < -hysteresis)
+            armed = true;
+        else if (before > hysteresis)
+            armed = false;
+
+        if (armed && before <= 0.0f && samples[(size_t)i] > 0.0f)
+            trigger = i;
+    }
+
+    if (trigger > 0)
+    {
+        const float before = samples[(size_t)trigger - 1];
+        const float after = samples[(size_t)trigger];
+        return (float)(trigger - 1) + before / (before - after);
+    }
+
+    // brak zbocza (cisza, DC) - bieg swobodny, ostatnie probki
+    return (float)juce::jmax(0, lastStart);
+}
+
+void OscilloscopeComponent::rebuildPath()
 {
-    g.fillAll(juce::Colour::fromRGB(56, 56, 56));
-    g.setColour(juce::Colours::lightgrey);
+    tracePath.clear();
+    traceDirty = false;
 
-    const juce::ScopedLock sl(bufferLock);
-    if (circularBuffer.empty())
+    const int numSamples = static_cast<int>(samples.size());
+    const auto area = getLocalBounds().toFloat();
+    const int width = getWidth();
+    if (numSamples < 2 || displaySamples < 2 || width < 2)
         return;
 
-    auto area = getLocalBounds().toFloat();
-    juce::Path path;
-    int numSamples = static_cast<int>(circularBuffer.size());
-    float startX = area.getX();
-    float endX = area.getRight();
-    float xIncrement = (endX - startX) / (numSamples - 1);
+    const float centreY = area.getCentreY();
+    const float scaleY = area.getHeight() * 0.5f;
+    auto toY = [&](float sample) { return centreY - sample * scaleY; };
+
+    // probka (wzgledem zbocza) -> piksel
+    const float samplesPerPixel = (float)(displaySamples - 1) / (float)(width - 1);
 
-    path.startNewSubPath(startX, area.getCentreY() - circularBuffer[0] * area.getHeight() * 0.5f);
-    for (int i = 1; i < numSamples; ++i)
+    if (samplesPerPixel <= 1.0f)
     {
-        float x = startX + i * xIncrement;
-        float y = area.getCentreY() - circularBuffer[i] * area.getHeight() * 0.5f;
-        path.lineTo(x, y);
+        // mniej probek niz pikseli - linia przez kolejne probki
+        const int first = (int)triggerPosition;
+        const int last = juce::jmin(numSamples - 1, (int)std::ceil(triggerPosition + (float)(displaySamples - 1)));
+        const float pixelsPerSample = 1.0f / samplesPerPixel;
+
+        tracePath.startNewSubPath(area.getX() + ((float)first - triggerPosition) * pixelsPerSample, toY(samples[(size_t)first]));
+        for (int i = first + 1; i <= last; ++i)
+            tracePath.lineTo(area.getX() + ((float)i - triggerPosition) * pixelsPerSample, toY(samples[(size_t)i]));
+        return;
+    }
+
+    // wiecej probek niz pikseli - min/max na kolumne, liczba punktow zalezy tylko od szerokosci
+    float previousY = 0.0f;
+    for (int column = 0; column < width; ++column)
+    {
+        const float start = triggerPosition + ((float)column - 0.5f) * samplesPerPixel;
+        const int from = juce::jlimit(0, numSamples - 1, (int)std::ceil(start));
+        const int to = juce::jlimit(from, numSamples - 1, (int)std::ceil(start + samplesPerPixel) - 1);
+
+        float low = samples[(size_t)from], high = low;
+        for (int i = from + 1; i <= to; ++i)
+        {
+            low = juce::jmin(low, samples[(size_t)i]);
+            high = juce::jmax(high, samples[(size_t)i]);
+        }
+
+        const float x = area.getX() + (float)column;
+        const float yHigh = toY(high), yLow = toY(low);
+
+        if (column == 0)
+        {
+            tracePath.startNewSubPath(x, yHigh);
+            tracePath.lineTo(x, yLow);
+            previousY = yLow;
+            continue;
+        }
+
+        // blizszy koniec kolumny pierwszy - bez przeskokow przez cala wysokosc
+        const bool highFirst = std::abs(yHigh - previousY) <= std::abs(yLow - previousY);
+        tracePath.lineTo(x, highFirst ? yHigh : yLow);
+        if (yHigh != yLow)
+            tracePath.lineTo(x, highFirst ? yLow : yHigh);
+        previousY = highFirst ? yLow : yHigh;
     }
-    g.strokePath(path, juce::PathStrokeType(2.0f));
 }
 
+void OscilloscopeComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colour::fromRGB(56, 56, 56));
+    g.setColour(juce::Colours::lightgrey);
 
+    if (traceDirty)
+        rebuildPath();
 
+    if (!tracePath.isEmpty())
+        g.strokePath(tracePath, juce::PathStrokeType(2.0f));
+}
 
 void OscilloscopeComponent::resized()
 {
+    // najwyzej dwa punkty na kolumne (lineTo = 3 wspolrzedne)
+    tracePath.preallocateSpace(getWidth() * 2 * 3 + 8);
+    traceDirty = true;
 }
 
-void OscilloscopeComponent::timerCallback()
+void OscilloscopeComponent::refresh()
 {
-    repaint();
+    // odswiezaj tylko gdy przyszly nowe probki
+    if (traceDirty)
+        repaint();
 }
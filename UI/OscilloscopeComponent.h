@@ -14,25 +14,32 @@
 #include <JuceHeader.h>
 #include <vector>
 
-class OscilloscopeComponent : public juce::Component,
-    public juce::Timer
+class OscilloscopeComponent : public juce::Component
 {
 public:
     OscilloscopeComponent();
     ~OscilloscopeComponent() override;
 
-    void pushSamples(const float* samples, int numSamples);
+    // numSamples probek z procesora, wyswietlane numDisplaySamples od ostatniego zbocza narastajacego
+    // (wszystko w watku UI - tak jak paint)
+    void pushSamples(const float* samples, int numSamples, int numDisplaySamples = -1);
 
     void paint(juce::Graphics&) override;
     void resized() override;
 
-    void timerCallback() override;
+    // wywolywane z timera edytora - odrysowanie tylko gdy przyszly nowe probki
+    void refresh();
 
 private:
-    std::vector<float> waveform;
-    juce::CriticalSection bufferLock;
-    std::vector<float> circularBuffer;
-    size_t writeIndex = 0;
-    const size_t bufferSize = 1024;
+    float findTrigger(int numDisplaySamples) const noexcept;
+    void rebuildPath();
+
+    std::vector<float> samples;         // pojemnosc tylko rosnie - bez alokacji w kolejnych ramkach
+    int displaySamples = 0;
+    float triggerPosition = 0.0f;       // ulamkowa pozycja przejscia przez zero
+
+    juce::Path tracePath;               // clear() zostawia pamiec - punkty z poprzedniej ramki
+    bool traceDirty = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscilloscopeComponent)
 };
\ No newline at end of file
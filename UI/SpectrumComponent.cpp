@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    SpectrumComponent.cpp
+    Created: 17 Oct 2026 11:59:50pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "SpectrumComponent.h"
+
+SpectrumComponent::SpectrumComponent(SpectrumAnalyser& analyserToUse)
+    : analyser(analyserToUse)
+{
+    setOpaque(true);
+}
+
+SpectrumComponent::~SpectrumComponent()
+{
+}
+
+void SpectrumComponent::rebuildPath()
+{
+    spectrumPath.clear();
+
+    const auto area = getLocalBounds().toFloat();
+    const float bandWidth = area.getWidth() / (float)SpectrumAnalyser::numBands;
+
+    // wypelniony obrys: od dolu, po srodkach pasm, z powrotem na dol
+    spectrumPath.startNewSubPath(area.getX(), area.getBottom());
+    for (int band = 0; band < SpectrumAnalyser::numBands; ++band)
+    {
+        const float x = area.getX() + ((float)band + 0.5f) * bandWidth;
+        const float y = area.getBottom() - levels[(size_t)band] * area.getHeight();
+        spectrumPath.lineTo(x, y);
+    }
+    spectrumPath.lineTo(area.getRight(), area.getBottom());
+    spectrumPath.closeSubPath();
+}
+
+void SpectrumComponent::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colour::fromRGB(56, 56, 56));
+
+    g.setColour(juce::Colours::lightgrey.withAlpha(0.3f));
+    g.fillPath(spectrumPath);
+    g.setColour(juce::Colours::lightgrey);
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+}
+
+void SpectrumComponent::resized()
+{
+    spectrumPath.preallocateSpace((SpectrumAnalyser::numBands + 4) * 3);
+    rebuildPath();
+}
+
+void SpectrumComponent::refresh()
+{
+    // tylko gdy analizator opublikowal nowa ramke
+    if (analyser.readSpectrum(levels.data()))
+    {
+        rebuildPath();
+        repaint();
+    }
+}
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    SpectrumComponent.h
+    Created: 17 Oct 2026 11:59:50pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "../Data/SpectrumAnalyser.h"
+
+// rysuje tylko gotowe pasma z SpectrumAnalyser - FFT liczy jego watek
+class SpectrumComponent : public juce::Component
+{
+public:
+    explicit SpectrumComponent(SpectrumAnalyser& analyser);
+    ~SpectrumComponent() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    // wywolywane z timera edytora
+    void refresh();
+
+private:
+    void rebuildPath();
+
+    SpectrumAnalyser& analyser;
+    std::array<float, SpectrumAnalyser::numBands> levels{};
+    juce::Path spectrumPath;            // clear() zostawia pamiec
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumComponent)
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    VoiceWorkerPool.cpp
+    Created: 17 Oct 2026 4:21:09pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#include "VoiceWorkerPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // petla czekania bez zabierania jednostek wykonawczych drugiemu watkowi rdzenia
+    inline void pauseCpu() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #elif JUCE_ARM && JUCE_MSVC
+        __yield();
+       #elif JUCE_ARM
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
+VoiceWorkerPool::~VoiceWorkerPool()
+{
+    release();
+}
+
+void VoiceWorkerPool::prepare(int numWorkersToCreate, double sampleRate, int samplesPerBlock)
+{
+    numWorkersToCreate = juce::jlimit(0, maxWorkers, numWorkersToCreate);
+
+    // te same ustawienia - pomocnicy dzialaja dalej, pol czytanych przez nich nie ruszamy
+    if (numWorkersToCreate == workers.size() && sampleRate == preparedSampleRate && samplesPerBlock == preparedBlockSize)
+    {
+        backoffBlocks = 0;
+        return;
+    }
+
+    // nowy czas bloku zmienia opcje realtime i czasy czekania - pomocnicy startuja od nowa
+    release();
+
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+
+    // pomocnik czeka bez spania dwa bloki - przy grajacym transporcie watek audio nigdy nie musi go budzic
+    const double blockSeconds = samplesPerBlock / juce::jmax(1.0, sampleRate);
+    const auto ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+    spinTicks = (juce::int64)(2.0 * blockSeconds * ticksPerSecond);
+    stallTicks = (juce::int64)(blockSeconds * ticksPerSecond);
+
+    // po zacieciu pomocnika okolo sekundy bez watkow
+    backoffLength = juce::jmax(1, (int)(1.0 / juce::jmax(1.0e-4, blockSeconds)));
+    backoffBlocks = 0;
+
+    for (int i = 0; i < numWorkersToCreate; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i + 1));
+
+        // pomocnicy z priorytetem watku audio - zwykly watek moglby zostac wywlaszczony w trakcie glosu
+        const auto options = juce::Thread::RealtimeOptions{}.withApproximateAudioProcessingTime(samplesPerBlock, sampleRate);
+        if (!worker->startRealtimeThread(options))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void VoiceWorkerPool::release()
+{
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto* worker : workers)
+    {
+        worker->wake();
+        worker->stopThread(1000);
+    }
+
+    workers.clear();
+}
+
+void VoiceWorkerPool::run(int numTasks, int maxWorkersToUse, TaskFunction function, void* context) noexcept
+{
+    jassert(numTasks <= maxTasks);
+
+    // po zacieciu liczymy sami - pomocnicy dalej sie kreca, ale nie dostaja zadan
+    const int allowed = backoffBlocks > 0 ? 0 : juce::jmin(maxWorkersToUse, workers.size());
+    if (backoffBlocks > 0)
+        --backoffBlocks;
+
+    taskFunction.store(function, std::memory_order_relaxed);
+    taskContext.store(context, std::memory_order_relaxed);
+    workersAllowed.store(allowed, std::memory_order_relaxed);
+    completedTasks.store(0, std::memory_order_relaxed);
+
+    // nowa generacja publikuje pola zadania (seq_cst - odczyt parked ponizej nie moze wyprzedzic zapisu)
+    const auto generation = getGeneration(claimState.load(std::memory_order_relaxed)) + 1;
+    claimState.store(makeClaim(generation, numTasks, 0));
+
+    // budzenie tylko pomocnikow, ktore spia (dluzej niz dwa bloki bez pracy)
+    for (int i = 0; i < allowed; ++i)
+    {
+        auto* worker = workers.getUnchecked(i);
+        if (worker->parked.load())
+            worker->wake();
+    }
+
+    // watek audio tez liczy i zabiera wszystko, czego pomocnicy nie zdazyli wziac
+    processTasks(generation, 0);
+
+    // czekamy juz tylko na zadania w trakcie liczenia
+    if (completedTasks.load(std::memory_order_acquire) >= numTasks)
+        return;
+
+    const auto waitStart = juce::Time::getHighResolutionTicks();
+    bool stalled = false;
+
+    for (int spins = 0; completedTasks.load(std::memory_order_acquire) < numTasks; ++spins)
+    {
+        pauseCpu();
+
+        // pomocnik wywlaszczony w srodku glosu - ten blok trzeba dokonczyc, kolejne bez pomocnikow
+        if (!stalled && (spins & 63) == 0 && juce::Time::getHighResolutionTicks() - waitStart > stallTicks)
+            stalled = true;
+    }
+
+    if (stalled)
+        backoffBlocks = backoffLength;
+}
+
+void VoiceWorkerPool::processTasks(juce::uint32 generation, int threadIndex) noexcept
+{
+    auto claim = claimState.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const int next = (int)(claim & 0xffff);
+        const int count = (int)((claim >> 16) & 0xffff);
+
+        if (getGeneration(claim) != generation || next >= count)
+            return;
+
+        // zadanie wziete tylko jesli slowo sie nie zmienilo (ta sama generacja, nikt nie wzial tego numeru)
+        if (claimState.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            taskFunction.load(std::memory_order_relaxed)(taskContext.load(std::memory_order_relaxed), next, threadIndex);
+            completedTasks.fetch_add(1, std::memory_order_release);
+            claim = claimState.load(std::memory_order_acquire);
+        }
+    }
+}
+
+//==============================================================================
+VoiceWorkerPool::Worker::Worker(VoiceWorkerPool& ownerPool, int index)
+    : juce::Thread("FM voice worker " + juce::String(index)),
+      pool(ownerPool),
+      threadIndex(index)
+{
+}
+
+void VoiceWorkerPool::Worker::run()
+{
+    auto idleSince = juce::Time::getHighResolutionTicks();
+    int spins = 0;
+
+    while (!threadShouldExit())
+    {
+        const auto generation = getGeneration(pool.claimState.load(std::memory_order_acquire));
+
+        if (generation != lastGeneration)
+        {
+            lastGeneration = generation;
+
+            if (threadIndex <= pool.workersAllowed.load(std::memory_order_relaxed))
+                pool.processTasks(generation, threadIndex);
+
+            idleSince = juce::Time::getHighResolutionTicks();
+            spins = 0;
+            continue;
+        }
+
+        // najpierw kreci sie czekajac na kolejny blok, co jakis czas oddaje rdzen
+        pauseCpu();
+        if ((++spins & 63) != 0)
+            continue;
+
+        if (juce::Time::getHighResolutionTicks() - idleSince < pool.spinTicks)
+        {
+            juce::Thread::yield();
+            continue;
+        }
+
+        // dluzej niz dwa bloki bez pracy (transport stoi) - zasypia, run() sprawdza parked po nowej generacji
+        parked.store(true);
+
+        if (getGeneration(pool.claimState.load()) == lastGeneration && !threadShouldExit())
+            wakeEvent.wait(-1);
+
+        parked.store(false);
+        idleSince = juce::Time::getHighResolutionTicks();
+        spins = 0;
+    }
+}
+
+void VoiceWorkerPool::Worker::wake() noexcept
+{
+    wakeEvent.signal();
+}
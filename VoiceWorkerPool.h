@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    VoiceWorkerPool.h
+    Created: 17 Oct 2026 4:21:09pm
+    Author:  majab
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// watki pomocnicze do liczenia glosow, tworzone poza watkiem audio
+// zadania rozdawane przez licznik atomowy - kto wolny ten bierze nastepne, watek audio zabiera wszystko
+// czego pomocnicy jeszcze nie wzieli
+class VoiceWorkerPool
+{
+public:
+    // task = numer zadania, thread = 0 dla watku audio, 1..n dla pomocnikow
+    using TaskFunction = void (*)(void* context, int taskIndex, int threadIndex);
+
+    static constexpr int maxWorkers = 15;
+    static constexpr int maxTasks = 0xffff;
+
+    ~VoiceWorkerPool();
+
+    // tworzy/usuwa watki (nigdy w watku audio) - czas bloku daje priorytet realtime i czas czekania przed uspieniem
+    void prepare(int numWorkersToCreate, double sampleRate, int samplesPerBlock);
+    void release();
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    // wykonuje zadania na watku audio i co najwyzej maxWorkersToUse pomocnikach, wraca gdy wszystkie skonczone
+    void run(int numTasks, int maxWorkersToUse, TaskFunction function, void* context) noexcept;
+
+    // pomocnik trzymal zadanie dluzej niz blok - przez jakis czas watek audio liczy sam
+    bool isBackingOff() const noexcept { return backoffBlocks > 0; }
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(VoiceWorkerPool& ownerPool, int index);
+        void run() override;
+        void wake() noexcept;
+
+    private:
+        VoiceWorkerPool& pool;
+        const int threadIndex;
+        juce::uint32 lastGeneration = 0;
+        juce::WaitableEvent wakeEvent;
+        std::atomic<bool> parked{ false };
+
+        friend class VoiceWorkerPool;
+    };
+
+    // stan zadania w jednym slowie: [generacja:32 | liczba zadan:16 | nastepne zadanie:16]
+    // spozniony pomocnik ze stara generacja nie wezmie juz niczego z nowego zadania
+    static juce::uint64 makeClaim(juce::uint32 generation, int numTasks, int nextTask) noexcept
+    {
+        return ((juce::uint64)generation << 32) | ((juce::uint64)numTasks << 16) | (juce::uint64)nextTask;
+    }
+
+    static juce::uint32 getGeneration(juce::uint64 claim) noexcept { return (juce::uint32)(claim >> 32); }
+
+    void processTasks(juce::uint32 generation, int threadIndex) noexcept;
+
+    juce::OwnedArray<Worker> workers;
+
+    std::atomic<TaskFunction> taskFunction{ nullptr };
+    std::atomic<void*> taskContext{ nullptr };
+    std::atomic<int> workersAllowed{ 0 };
+
+    std::atomic<juce::uint64> claimState{ 0 };
+    std::atomic<int> completedTasks{ 0 };
+
+    // w tickach zegara: pomocnik kreci sie tyle bez pracy zanim zasnie, watek audio czeka tyle zanim uzna pomocnika za wywlaszczonego
+    // zapisywane tylko w prepare() gdy zaden pomocnik nie dziala
+    juce::int64 spinTicks = 0;
+    juce::int64 stallTicks = 0;
+
+    // ustawienia, z ktorymi wystartowali obecni pomocnicy
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+
+    // tylko watek audio
+    int backoffBlocks = 0;
+    int backoffLength = 0;
+};